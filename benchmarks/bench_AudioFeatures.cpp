@@ -0,0 +1,144 @@
+#include "bench_Common.h"
+#include "tb_AudioFeatures.h"
+#include "tb_RunningRms.h"
+#include "tb_SpectralDescriptors.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+std::vector<float> makeSpectrum(std::size_t numBins) {
+    std::vector<float> spectrum(numBins);
+    for (std::size_t k = 0; k < numBins; ++k)
+        spectrum[k] = 1.f + std::sin(0.05f * static_cast<float>(k));
+    return spectrum;
+}
+
+// Args: FFT size, mel bins
+void BM_applyMelFilterbank_Dense(benchmark::State& state) {
+    const auto numBins = static_cast<std::size_t>(state.range(0) / 2 + 1);
+    const auto numMelBins = static_cast<std::size_t>(state.range(1));
+    const auto fb = tb::melFilterbank(numMelBins, numBins, 48000.0);
+    const auto spectrum = makeSpectrum(numBins);
+    std::vector<float> mel(numMelBins);
+
+    for (auto _ : state) {
+        tb::applyMelFilterbank(spectrum, fb, mel);
+        benchmark::DoNotOptimize(mel.data());
+    }
+    setThroughput(state, static_cast<int64_t>(numBins), 1);
+}
+
+void BM_applyMelFilterbank_Sparse(benchmark::State& state) {
+    const auto numBins = static_cast<std::size_t>(state.range(0) / 2 + 1);
+    const auto numMelBins = static_cast<std::size_t>(state.range(1));
+    const auto fb = tb::sparseMelFilterbank(numMelBins, numBins, 48000.0);
+    const auto spectrum = makeSpectrum(numBins);
+    std::vector<float> mel(numMelBins);
+
+    for (auto _ : state) {
+        tb::applyMelFilterbank(spectrum, fb, mel);
+        benchmark::DoNotOptimize(mel.data());
+    }
+    setThroughput(state, static_cast<int64_t>(numBins), 1);
+}
+
+// Args: FFT size, mel bins, frames per batch
+void BM_applyMelFilterbankBatch(benchmark::State& state) {
+    const auto numBins = static_cast<std::size_t>(state.range(0) / 2 + 1);
+    const auto numMelBins = static_cast<std::size_t>(state.range(1));
+    const auto numFrames = static_cast<std::size_t>(state.range(2));
+    const auto fb = tb::sparseMelFilterbank(numMelBins, numBins, 48000.0);
+    const auto spectrogram = makeSpectrum(numBins * numFrames);
+    std::vector<float> mel(numMelBins * numFrames);
+
+    for (auto _ : state) {
+        tb::applyMelFilterbankBatch(spectrogram, fb, mel);
+        benchmark::DoNotOptimize(mel.data());
+    }
+    setThroughput(state, static_cast<int64_t>(numBins * numFrames), static_cast<int64_t>(numFrames));
+}
+
+// Args: mel bins, accuracy (0 = exact, 1 = fast)
+void BM_logCompress(benchmark::State& state) {
+    const auto energies = makeSpectrum(static_cast<std::size_t>(state.range(0)));
+    const tb::LogCompression compression { tb::LogScale::Decibels,
+                                           state.range(1) != 0 ? tb::LogAccuracy::Fast : tb::LogAccuracy::Exact };
+    std::vector<float> mel(energies.size());
+
+    for (auto _ : state) {
+        tb::logCompress(energies, mel, compression);
+        benchmark::DoNotOptimize(mel.data());
+    }
+    setThroughput(state, state.range(0), 1);
+}
+
+// Args: number of bins / samples
+void BM_spectralFlux(benchmark::State& state) {
+    const auto numBins = static_cast<std::size_t>(state.range(0));
+    const auto prev = makeSpectrum(numBins);
+    auto curr = makeSpectrum(numBins);
+    std::reverse(curr.begin(), curr.end());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tb::spectralFlux(prev, curr));
+    setThroughput(state, static_cast<int64_t>(numBins), 1);
+}
+
+void BM_spectralCentroid(benchmark::State& state) {
+    const auto spectrum = makeSpectrum(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tb::spectralCentroid(spectrum, 48000.0));
+    setThroughput(state, state.range(0), 1);
+}
+
+void BM_rmsEnergy(benchmark::State& state) {
+    const auto samples = makeSpectrum(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tb::rmsEnergy(samples));
+    setThroughput(state, state.range(0), 1);
+}
+
+void BM_SpectralDescriptors(benchmark::State& state) {
+    const auto numBins = static_cast<std::size_t>(state.range(0));
+    const auto spectrum = makeSpectrum(numBins);
+    tb::SpectralDescriptorAnalyser analyser(numBins, 48000.0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(analyser.process(spectrum));
+    setThroughput(state, state.range(0), 1);
+}
+
+// Per-sample RMS output over a 512-sample block: (channels, window, mode)
+void BM_RunningRms_process(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto mode = static_cast<tb::RunningRms::Mode>(state.range(2));
+    constexpr int blockSize = 512;
+
+    tb::RunningRms rms(numChannels, static_cast<int>(state.range(1)), mode);
+    choc::buffer::ChannelArrayBuffer<float> input(numChannels, blockSize);
+    choc::buffer::ChannelArrayBuffer<float> output(numChannels, blockSize);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.getSample(ch, i) = std::sin(0.01f * static_cast<float>(i + ch));
+
+    for (auto _ : state) {
+        rms.process(input, output);
+        benchmark::DoNotOptimize(output.getChannel(0).data.data);
+    }
+    setThroughput(state, int64_t { numChannels } * blockSize, blockSize);
+}
+
+}
+
+BENCHMARK(BM_applyMelFilterbank_Dense)->ArgsProduct({ { 512, 2048, 4096 }, { 40, 128 } });
+BENCHMARK(BM_applyMelFilterbank_Sparse)->ArgsProduct({ { 512, 2048, 4096 }, { 40, 128 } });
+BENCHMARK(BM_applyMelFilterbankBatch)->ArgsProduct({ { 2048, 4096 }, { 40, 128 }, { 64, 512 } });
+BENCHMARK(BM_logCompress)->ArgsProduct({ { 40, 128 }, { 0, 1 } });
+BENCHMARK(BM_spectralFlux)->Arg(257)->Arg(1025)->Arg(2049);
+BENCHMARK(BM_spectralCentroid)->Arg(257)->Arg(1025)->Arg(2049);
+BENCHMARK(BM_SpectralDescriptors)->Arg(257)->Arg(1025)->Arg(2049);
+BENCHMARK(BM_rmsEnergy)->Arg(256)->Arg(1024)->Arg(4096);
+BENCHMARK(BM_RunningRms_process)->ArgsProduct({ { 1, 64 }, { 4800 }, { 0, 1 } });
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Reports throughput as samples per second and the average time spent per frame (one hop,
+// block or output frame, depending on the benchmark). Both are iteration-invariant counts. The
+// inverted rate is in seconds, which the console prints with an SI prefix, e.g. 59.4ns.
+inline void setThroughput(benchmark::State& state, int64_t samplesPerIteration,
+                          int64_t framesPerIteration) {
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(samplesPerIteration),
+                                                     benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["time/frame"] = benchmark::Counter(static_cast<double>(framesPerIteration),
+                                                      benchmark::Counter::kIsIterationInvariantRate |
+                                                          benchmark::Counter::kInvert);
+}
@@ -0,0 +1,69 @@
+#include "bench_Common.h"
+#include "tb_FifoBuffer.h"
+#include "tb_SampleFormat.h"
+
+#include <choc_SampleBuffers.h>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Args: channels, block size. Pushes a block, then pops it again
+void BM_FifoBuffer_PushPop(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto blockSize = static_cast<int>(state.range(1));
+    tb::FifoBuffer<float> fifo(numChannels, blockSize * 4);
+    choc::buffer::ChannelArrayBuffer<float> block(numChannels, blockSize);
+
+    // Keep the FIFO partly full, so pop() has data to shift
+    fifo.push(block);
+    fifo.push(block);
+
+    for (auto _ : state) {
+        fifo.push(block);
+        fifo.pop(blockSize);
+        benchmark::ClobberMemory();
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * blockSize, blockSize);
+}
+
+void BM_SpscFifoBuffer_PushPop(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto blockSize = static_cast<int>(state.range(1));
+    tb::SpscFifoBuffer<float> fifo(numChannels, blockSize * 4);
+    choc::buffer::ChannelArrayBuffer<float> block(numChannels, blockSize);
+
+    fifo.push(block);
+    fifo.push(block);
+
+    for (auto _ : state) {
+        fifo.push(block);
+        fifo.pop(blockSize);
+        benchmark::ClobberMemory();
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * blockSize, blockSize);
+}
+
+
+// Args: channels, block size. Converts interleaved int16 straight into the FIFO, then pops it
+void BM_FifoBuffer_PushInterleavedInt16(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto blockSize = static_cast<int>(state.range(1));
+    tb::SpscFifoBuffer<float> fifo(numChannels, blockSize * 4);
+    std::vector<int16_t> block(static_cast<std::size_t>(numChannels * blockSize));
+    for (std::size_t i = 0; i < block.size(); ++i)
+        block[i] = static_cast<int16_t>(i * 31);
+
+    for (auto _ : state) {
+        tb::pushInterleaved<int16_t>(fifo, block);
+        fifo.pop(blockSize);
+        benchmark::ClobberMemory();
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * blockSize, blockSize);
+}
+
+}
+
+BENCHMARK(BM_FifoBuffer_PushPop)->ArgsProduct({ { 1, 2, 8 }, { 64, 512, 4096 } });
+BENCHMARK(BM_SpscFifoBuffer_PushPop)->ArgsProduct({ { 1, 2, 8 }, { 64, 512, 4096 } });
+BENCHMARK(BM_FifoBuffer_PushInterleavedInt16)->ArgsProduct({ { 1, 2, 8 }, { 64, 512, 4096 } });
@@ -0,0 +1,110 @@
+#include "bench_Common.h"
+#include "tb_Interpolation.h"
+#include "tb_WaveformPyramid.h"
+#include "tb_Windowing.h"
+
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Args: control points, interpolation steps
+void BM_catmullRom_spline(benchmark::State& state) {
+    const auto numPoints = static_cast<int>(state.range(0));
+    const auto steps = static_cast<int>(state.range(1));
+
+    std::vector<tb::Point> inLine(numPoints);
+    for (int i = 0; i < numPoints; ++i)
+        inLine[i] = tb::Point(static_cast<float>(i), std::sin(0.1f * static_cast<float>(i)));
+    std::vector<tb::Point> outLine(tb::catmullRom::outLineSize(numPoints, steps));
+
+    for (auto _ : state) {
+        tb::catmullRom::spline(outLine, inLine, steps, tb::catmullRom::Type::Uniform);
+        benchmark::DoNotOptimize(outLine.data());
+    }
+    setThroughput(state, static_cast<int64_t>(outLine.size()), numPoints);
+}
+
+void BM_catmullRom_splineBasis(benchmark::State& state) {
+    const auto numPoints = static_cast<int>(state.range(0));
+    const auto steps = static_cast<int>(state.range(1));
+
+    tb::PointBuffer inLine(static_cast<std::size_t>(numPoints));
+    for (int i = 0; i < numPoints; ++i)
+        inLine.set(static_cast<std::size_t>(i), tb::Point(static_cast<float>(i), std::sin(0.1f * static_cast<float>(i))));
+    const auto size = static_cast<std::size_t>(tb::catmullRom::outLineSize(numPoints, steps));
+    tb::PointBuffer outLine(size);
+    const tb::catmullRom::UniformBasis basis(steps);
+
+    for (auto _ : state) {
+        tb::catmullRom::spline(outLine, inLine, basis);
+        benchmark::DoNotOptimize(outLine.x().data());
+        benchmark::DoNotOptimize(outLine.y().data());
+    }
+    setThroughput(state, static_cast<int64_t>(size), numPoints);
+}
+
+// Args: control points, output points, type
+void BM_catmullRom_sample(benchmark::State& state) {
+    const auto numPoints = static_cast<int>(state.range(0));
+    const auto numOut = static_cast<std::size_t>(state.range(1));
+    const auto type = static_cast<tb::catmullRom::Type>(state.range(2));
+
+    std::vector<tb::Point> inLine(numPoints);
+    for (int i = 0; i < numPoints; ++i)
+        inLine[i] = tb::Point(static_cast<float>(i), std::sin(0.1f * static_cast<float>(i)));
+    std::vector<float> positions(numOut);
+    for (std::size_t i = 0; i < numOut; ++i)
+        positions[i] = 1.f + static_cast<float>(numPoints - 3) * static_cast<float>(i) / static_cast<float>(numOut);
+    std::vector<tb::Point> outLine(numOut);
+
+    for (auto _ : state) {
+        tb::catmullRom::sample(outLine, inLine, positions, type);
+        benchmark::DoNotOptimize(outLine.data());
+    }
+    setThroughput(state, static_cast<int64_t>(numOut), numPoints);
+}
+
+// Args: recording length in samples, pixels
+void BM_WaveformPyramid_query(benchmark::State& state) {
+    const auto numSamples = static_cast<int>(state.range(0));
+    const auto numPixels = static_cast<std::size_t>(state.range(1));
+
+    choc::buffer::ChannelArrayBuffer<float> audio(1, numSamples);
+    auto* data = audio.getView().getChannel(0).data.data;
+    for (int i = 0; i < numSamples; ++i)
+        data[i] = std::sin(0.01f * static_cast<float>(i));
+
+    tb::WaveformPyramid pyramid(1);
+    pyramid.append(audio.getView());
+    std::vector<tb::WaveformSummary> pixels(numPixels);
+
+    for (auto _ : state) {
+        pyramid.query(0, 0.0, numSamples, pixels);
+        benchmark::DoNotOptimize(pixels.data());
+    }
+    setThroughput(state, static_cast<int64_t>(numPixels), 1);
+}
+
+// Args: window type, size
+void BM_window(benchmark::State& state) {
+    const auto type = static_cast<tb::WindowType>(state.range(0));
+    const auto size = static_cast<int>(state.range(1));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(tb::window<float>(type, size));
+    setThroughput(state, size, 1);
+}
+
+}
+
+BENCHMARK(BM_catmullRom_spline)->ArgsProduct({ { 64, 1024, 16384 }, { 1, 4, 16 } });
+BENCHMARK(BM_catmullRom_splineBasis)->ArgsProduct({ { 64, 1024, 16384 }, { 1, 4, 16 } });
+BENCHMARK(BM_catmullRom_sample)->ArgsProduct({ { 1024, 16384 }, { 1920 },
+                                               { static_cast<int64_t>(tb::catmullRom::Type::Uniform),
+                                                 static_cast<int64_t>(tb::catmullRom::Type::Centripetal) } });
+BENCHMARK(BM_WaveformPyramid_query)->ArgsProduct({ { 48000 * 60, 48000 * 3600 }, { 2000 } });
+BENCHMARK(BM_window)->ArgsProduct({ { static_cast<int64_t>(tb::WindowType::Hann),
+                                      static_cast<int64_t>(tb::WindowType::BlackmanHarris) },
+                                    { 512, 2048, 8192 } });
@@ -0,0 +1,36 @@
+#include "bench_Common.h"
+#include "tb_DspUtilities.h"
+#include "tb_PolyphaseResampler.h"
+
+#include <choc_SampleBuffers.h>
+
+namespace {
+
+constexpr int kBlockSize = 512;
+
+// Args: channels, quality, ratio (0: 44.1k → 48k, 1: 48k → 44.1k)
+void BM_PolyphaseResampler_process(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto quality = static_cast<tb::PolyphaseResampler::Quality>(state.range(1));
+    const auto inRate = state.range(2) == 0 ? 44100.0 : 48000.0;
+    const auto outRate = state.range(2) == 0 ? 48000.0 : 44100.0;
+
+    tb::PolyphaseResampler resampler(numChannels, inRate, outRate, quality);
+    auto input = tb::makeSineWave(440.f, inRate, numChannels, kBlockSize);
+    choc::buffer::ChannelArrayBuffer<float> output(numChannels, kBlockSize * 2);
+
+    for (auto _ : state) {
+        auto [in, out] = resampler.process(input, output);
+        benchmark::DoNotOptimize(out.getNumFrames());
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * kBlockSize, kBlockSize);
+}
+
+}
+
+BENCHMARK(BM_PolyphaseResampler_process)
+    ->ArgsProduct({ { 1, 2, 16 },
+                    { static_cast<int64_t>(tb::PolyphaseResampler::Quality::BestQuality),
+                      static_cast<int64_t>(tb::PolyphaseResampler::Quality::MediumQuality),
+                      static_cast<int64_t>(tb::PolyphaseResampler::Quality::Fastest) },
+                    { 0, 1 } });
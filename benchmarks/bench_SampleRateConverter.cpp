@@ -0,0 +1,40 @@
+#include "bench_Common.h"
+#include "tb_DspUtilities.h"
+#include "tb_SampleRateConverter.h"
+
+#include <choc_SampleBuffers.h>
+
+namespace {
+
+constexpr int kBlockSize = 512;
+
+// Output rate for a given input rate, as benchmark args are integers
+double outputRateFor(int64_t ratioIndex) { return ratioIndex == 0 ? 48000.0 : 44100.0; }
+double inputRateFor(int64_t ratioIndex) { return ratioIndex == 0 ? 44100.0 : 48000.0; }
+
+// Args: channels, quality, ratio (0: 44.1k → 48k, 1: 48k → 44.1k)
+void BM_SampleRateConverter_process(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto quality = static_cast<tb::SampleRateConverter::Quality>(state.range(1));
+    const auto inRate = inputRateFor(state.range(2));
+    const auto outRate = outputRateFor(state.range(2));
+
+    tb::SampleRateConverter converter(numChannels, quality);
+    auto input = tb::makeSineWave(440.f, inRate, numChannels, kBlockSize);
+    choc::buffer::ChannelArrayBuffer<float> output(numChannels, kBlockSize * 2);
+
+    for (auto _ : state) {
+        auto [in, out] = converter.process(input, output, inRate, outRate);
+        benchmark::DoNotOptimize(out.getNumFrames());
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * kBlockSize, kBlockSize);
+}
+
+}
+
+BENCHMARK(BM_SampleRateConverter_process)
+    ->ArgsProduct({ { 1, 2, 16 },
+                    { static_cast<int64_t>(tb::SampleRateConverter::Quality::BestQuality),
+                      static_cast<int64_t>(tb::SampleRateConverter::Quality::MediumQuality),
+                      static_cast<int64_t>(tb::SampleRateConverter::Quality::Fastest) },
+                    { 0, 1 } });
@@ -0,0 +1,79 @@
+#include "bench_Common.h"
+#include "tb_DspUtilities.h"
+#include "tb_Fft.h"
+#include "tb_OnsetDetection.h"
+#include "tb_Stft.h"
+
+#include <complex>
+#include <vector>
+
+namespace {
+
+// Args: FFT size
+void BM_Fft_forward(benchmark::State& state) {
+    const auto size = static_cast<int>(state.range(0));
+    tb::Fft fft(size);
+    std::vector<float> input(size, 0.5f);
+    std::vector<std::complex<float>> output(fft.numBins());
+
+    for (auto _ : state) {
+        fft.forward(input, output);
+        benchmark::DoNotOptimize(output.data());
+    }
+    setThroughput(state, size, 1);
+}
+
+// Args: channels, frame size, hop size. Streams one second of audio in 512-sample blocks
+void BM_Stft_process(benchmark::State& state) {
+    const auto numChannels = static_cast<int>(state.range(0));
+    const auto frameSize = static_cast<int>(state.range(1));
+    const auto hopSize = static_cast<int>(state.range(2));
+    const int numSamples = 48000;
+    const int blockSize = 512;
+
+    tb::Stft stft(numChannels, frameSize, hopSize);
+    auto signal = tb::makeSineWave(440.f, 48000.0, numChannels, numSamples);
+
+    int64_t numFrames = 0;
+    for (auto _ : state) {
+        numFrames = 0;
+        for (int start = 0; start + blockSize <= numSamples; start += blockSize)
+            numFrames += stft.process(signal.getFrameRange({ static_cast<uint32_t>(start),
+                                                             static_cast<uint32_t>(start + blockSize) }),
+                                      [](const tb::Stft& s) { benchmark::DoNotOptimize(s.getPowerSpectrum(0).data()); });
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * numSamples, numFrames);
+}
+
+// Args: frame size, spectra (0 = PowerAndMagnitude, 1 = PowerOnly). One second of stereo audio
+// through the analyseOffline() flux path: magnitudes written into each tracker's next frame
+void BM_Stft_fluxInPlace(benchmark::State& state) {
+    const int numChannels = 2;
+    const auto frameSize = static_cast<int>(state.range(0));
+    const auto spectra = state.range(1) == 0 ? tb::Stft::Spectra::PowerAndMagnitude : tb::Stft::Spectra::PowerOnly;
+    const int hopSize = frameSize / 4;
+    const int numSamples = 48000;
+
+    tb::Stft stft(numChannels, frameSize, hopSize, tb::WindowType::Hann, tb::WindowSymmetry::Symmetric, spectra);
+    std::vector<tb::SpectralFluxTracker> trackers(numChannels,
+                                                  tb::SpectralFluxTracker(static_cast<std::size_t>(stft.getNumBins())));
+    auto signal = tb::makeSineWave(440.f, 48000.0, numChannels, numSamples);
+
+    int64_t numFrames = 0;
+    for (auto _ : state) {
+        stft.reset();
+        numFrames = stft.process(signal, [&](const tb::Stft& s) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                s.getMagnitudeSpectrum(ch, trackers[ch].getNextFrame());
+                benchmark::DoNotOptimize(trackers[ch].processNextFrame());
+            }
+        });
+    }
+    setThroughput(state, static_cast<int64_t>(numChannels) * numSamples, numFrames);
+}
+
+}
+
+BENCHMARK(BM_Fft_forward)->Arg(512)->Arg(2048)->Arg(4096);
+BENCHMARK(BM_Stft_process)->ArgsProduct({ { 1, 2 }, { 1024, 4096 }, { 256, 512 } });
+BENCHMARK(BM_Stft_fluxInPlace)->ArgsProduct({ { 1024, 4096 }, { 0, 1 } });
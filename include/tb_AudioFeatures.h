@@ -1,10 +1,20 @@
 #pragma once
 
+#include "tb_Instrumentation.h"
+#include "tb_Simd.h"
+
+#include <algorithm>
 #include <span>
 #include <vector>
 #include <array>
 #include <cmath>
 #include <cassert>
+#include <limits>
+#include <numbers>
+#include <compare>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace tb {
 
@@ -17,40 +27,91 @@ namespace tb {
 //
 //  nFftBins  = N/2 + 1  (one-sided, inclusive)
 //  fMin/fMax = frequency range to cover (Hz)
+//
+//  The FilterbankSettings overloads also offer other auditory scales and
+//  Slaney-style area normalisation:
+//
+//    MelHtk     2595 · log10(1 + f / 700)                     (default)
+//    MelSlaney  linear below 1 kHz, logarithmic above (Slaney's Auditory
+//               Toolbox, librosa's default)
+//    Bark       Traunmüller (1990)
+//    Erb        ERB-rate, Glasberg & Moore (1990)
+//
+//  Slaney normalisation scales each triangle by 2 / (its width in Hz), so
+//  every band has the same area instead of the same peak.
 // ─────────────────────────────────────────────────────────────────────────────
 
-inline std::vector<std::vector<float>> melFilterbank(
-        std::size_t nMelBins,
-        std::size_t nFftBins,
-        double      sampleRate,
-        double      fMin = 20.0,
-        double      fMax = -1.0)   // -1 → nyquist
+enum class FrequencyScale { MelHtk, MelSlaney, Bark, Erb };
+
+enum class FilterbankNorm { None, Slaney };
+
+struct FilterbankSettings {
+    std::size_t    nMelBins   = 40;
+    std::size_t    nFftBins   = 1025;
+    double         sampleRate = 48000.0;
+    double         fMin       = 20.0;
+    double         fMax       = -1.0;   // -1 → nyquist
+    FrequencyScale scale      = FrequencyScale::MelHtk;
+    FilterbankNorm norm       = FilterbankNorm::None;
+
+    auto operator<=>(const FilterbankSettings&) const = default;
+};
+
+namespace detail {
+
+inline double hzToScale(FrequencyScale scale, double hz)
 {
-    if (fMax < 0.0)
-        fMax = sampleRate / 2.0;
+    switch (scale) {
+        case FrequencyScale::MelHtk:
+            return 2595.0 * std::log10(1.0 + hz / 700.0);
+        case FrequencyScale::MelSlaney:
+            return hz < 1000.0 ? hz * 3.0 / 200.0
+                               : 15.0 + 27.0 * std::log(hz / 1000.0) / std::log(6.4);
+        case FrequencyScale::Bark:
+            return 26.81 * hz / (1960.0 + hz) - 0.53;
+        case FrequencyScale::Erb:
+            return 21.4 * std::log10(1.0 + 0.00437 * hz);
+    }
+    return hz;
+}
 
-    // Hz → mel
-    auto hzToMel = [](double hz) {
-        return 2595.0 * std::log10(1.0 + hz / 700.0);
-    };
-    // mel → Hz
-    auto melToHz = [](double mel) {
-        return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
-    };
+inline double scaleToHz(FrequencyScale scale, double value)
+{
+    switch (scale) {
+        case FrequencyScale::MelHtk:
+            return 700.0 * (std::pow(10.0, value / 2595.0) - 1.0);
+        case FrequencyScale::MelSlaney:
+            return value < 15.0 ? value * 200.0 / 3.0
+                                : 1000.0 * std::exp((value - 15.0) * std::log(6.4) / 27.0);
+        case FrequencyScale::Bark:
+            return 1960.0 * (value + 0.53) / (26.28 - value);
+        case FrequencyScale::Erb:
+            return (std::pow(10.0, value / 21.4) - 1.0) / 0.00437;
+    }
+    return value;
+}
+
+}
 
-    const double melMin = hzToMel(fMin);
-    const double melMax = hzToMel(fMax);
+inline std::vector<std::vector<float>> melFilterbank(const FilterbankSettings& settings)
+{
+    const auto nMelBins = settings.nMelBins;
+    const auto nFftBins = settings.nFftBins;
+    const auto fMax     = settings.fMax < 0.0 ? settings.sampleRate / 2.0 : settings.fMax;
+
+    const double melMin = detail::hzToScale(settings.scale, settings.fMin);
+    const double melMax = detail::hzToScale(settings.scale, fMax);
 
-    // nMelBins + 2 equally-spaced mel points (includes lower/upper edges)
+    // nMelBins + 2 equally-spaced points on the scale (includes lower/upper edges)
     std::vector<double> melPoints(nMelBins + 2);
     for (std::size_t i = 0; i < melPoints.size(); ++i)
         melPoints[i] = melMin + i * (melMax - melMin) / (nMelBins + 1);
 
     // Convert to FFT bin indices
-    const double freqResolution = (sampleRate / 2.0) / (nFftBins - 1);
+    const double freqResolution = (settings.sampleRate / 2.0) / (nFftBins - 1);
     std::vector<double> binFreqs(nMelBins + 2);
     for (std::size_t i = 0; i < binFreqs.size(); ++i)
-        binFreqs[i] = melToHz(melPoints[i]) / freqResolution;
+        binFreqs[i] = detail::scaleToHz(settings.scale, melPoints[i]) / freqResolution;
 
     // Build triangular filters
     std::vector<std::vector<float>> fb(nMelBins, std::vector<float>(nFftBins, 0.f));
@@ -59,39 +120,254 @@ inline std::vector<std::vector<float>> melFilterbank(
         const double left   = binFreqs[m];
         const double center = binFreqs[m + 1];
         const double right  = binFreqs[m + 2];
+        const double gain   = settings.norm == FilterbankNorm::Slaney
+                                ? 2.0 / ((right - left) * freqResolution)
+                                : 1.0;
 
         for (std::size_t k = 0; k < nFftBins; ++k) {
             const double f = static_cast<double>(k);
             if (f >= left && f <= center && center != left)
-                fb[m][k] = static_cast<float>((f - left) / (center - left));
+                fb[m][k] = static_cast<float>(gain * (f - left) / (center - left));
             else if (f > center && f <= right && right != center)
-                fb[m][k] = static_cast<float>((right - f) / (right - center));
+                fb[m][k] = static_cast<float>(gain * (right - f) / (right - center));
         }
     }
 
     return fb;
 }
 
+inline std::vector<std::vector<float>> melFilterbank(
+        std::size_t nMelBins,
+        std::size_t nFftBins,
+        double      sampleRate,
+        double      fMin = 20.0,
+        double      fMax = -1.0)   // -1 → nyquist
+{
+    return melFilterbank(FilterbankSettings { .nMelBins   = nMelBins,
+                                              .nFftBins   = nFftBins,
+                                              .sampleRate = sampleRate,
+                                              .fMin       = fMin,
+                                              .fMax       = fMax });
+}
+
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Log compression
+//
+//  Maps a whole vector of energies to log(max(x, floor)) in one call, as
+//  natural log, log10 or decibels (10 · log10, i.e. power dB).
+//
+//  Exact     std::log in double, per element
+//  Fast      vectorised fastLog2() (tb_Math.h): |error| < 5e-6 in log2,
+//            i.e. < 4e-6 natural, < 2e-6 log10, < 2e-5 dB
+//
+//  The floor must be a positive, normal float; zeros, negatives and NaNs
+//  all come out as log(floor).
+// ─────────────────────────────────────────────────────────────────────────────
+
+enum class LogScale { Natural, Log10, Decibels };
+
+enum class LogAccuracy { Exact, Fast };
+
+struct LogCompression {
+    LogScale    scale    = LogScale::Natural;
+    LogAccuracy accuracy = LogAccuracy::Exact;
+    float       floor    = 1e-9f;
+};
+
+// dst may be the same memory as src.
+inline void logCompress(
+        std::span<const float> src,
+        std::span<float>       dst,
+        const LogCompression&  settings = {})
+{
+    assert(src.size() == dst.size());
+    assert(settings.floor >= std::numeric_limits<float>::min());
+
+    // Natural log → requested scale
+    const double toScale = settings.scale == LogScale::Natural ? 1.0
+                         : settings.scale == LogScale::Log10   ? 1.0 / std::numbers::ln10
+                                                               : 10.0 / std::numbers::ln10;
+
+    if (settings.accuracy == LogAccuracy::Fast) {
+        simd::scaledLog2(src, dst, settings.floor, static_cast<float>(toScale * std::numbers::ln2));
+        return;
+    }
+
+    for (std::size_t i = 0; i < src.size(); ++i)
+        dst[i] = static_cast<float>(toScale * std::log(static_cast<double>(std::max(settings.floor, src[i]))));
+}
+
 
 // Apply a pre-built mel filterbank to a one-sided FFT power spectrum.
 // Writes log-compressed energy into dst (must have nMelBins elements).
 // log(x + 1e-9) keeps -inf away from silent frames.
+//
+// The reductions in this file run on the dispatched kernels in tb_Simd.h,
+// which accumulate in float lanes per block and in double across blocks
+// (see the precision contract there).
 inline void applyMelFilterbank(
         std::span<const float>              fftPowerSpectrum,
         const std::vector<std::vector<float>>& fb,
         std::span<float>                    dst)
 {
+    tb_instrumentStage(MelApply);
     assert(dst.size() == fb.size());
     for (std::size_t m = 0; m < fb.size(); ++m) {
         assert(fb[m].size() == fftPowerSpectrum.size());
-        double energy = 0.0;
-        for (std::size_t k = 0; k < fftPowerSpectrum.size(); ++k)
-            energy += fb[m][k] * fftPowerSpectrum[k];
+        const double energy = simd::dot(fb[m], fftPowerSpectrum);
         dst[m] = static_cast<float>(std::log(energy + 1e-9));
     }
 }
 
 
+// ─────────────────────────────────────────────────────────────────────────────
+//  Sparse mel filterbank
+//
+//  Each triangular filter is non-zero over only a short contiguous run of FFT
+//  bins, so a band is stored as (startBin, length) plus its run of weights.
+//  The runs of all bands live back to back in one flat `weights` allocation,
+//  and applyMelFilterbank() only touches the non-zero span of each band.
+//
+//  Build once with sparseMelFilterbank() (or makeSparse() on an existing
+//  dense matrix); the result gives identical output to the dense path.
+// ─────────────────────────────────────────────────────────────────────────────
+
+struct SparseMelFilterbank {
+    struct Band {
+        std::size_t startBin = 0;   // first non-zero FFT bin
+        std::size_t offset   = 0;   // index of the band's first weight in `weights`
+        std::size_t length   = 0;   // number of weights in the run (0 → empty band)
+    };
+
+    std::vector<Band>  bands;       // one per mel bin
+    std::vector<float> weights;     // every band's run, back to back
+    std::size_t        numFftBins = 0;
+
+    std::size_t numMelBins() const { return bands.size(); }
+
+    std::span<const float> bandWeights(std::size_t m) const {
+        return std::span<const float>(weights).subspan(bands[m].offset, bands[m].length);
+    }
+};
+
+
+// Compresses a dense (nMelBins × nFftBins) filterbank into its sparse form.
+// Each band keeps the run from its first to its last non-zero weight.
+inline SparseMelFilterbank makeSparse(const std::vector<std::vector<float>>& fb)
+{
+    SparseMelFilterbank sparse;
+    sparse.numFftBins = fb.empty() ? 0 : fb.front().size();
+    sparse.bands.resize(fb.size());
+
+    std::size_t numWeights = 0;
+    for (std::size_t m = 0; m < fb.size(); ++m) {
+        assert(fb[m].size() == sparse.numFftBins);
+        const auto first = std::find_if(fb[m].begin(), fb[m].end(), [](float w) { return w != 0.f; });
+        if (first == fb[m].end())
+            continue;
+
+        const auto last = std::find_if(fb[m].rbegin(), fb[m].rend(), [](float w) { return w != 0.f; });
+        auto& band    = sparse.bands[m];
+        band.startBin = static_cast<std::size_t>(first - fb[m].begin());
+        band.length   = static_cast<std::size_t>(last.base() - first);
+        band.offset   = numWeights;
+        numWeights   += band.length;
+    }
+
+    sparse.weights.reserve(numWeights);
+    for (std::size_t m = 0; m < fb.size(); ++m) {
+        const auto& band = sparse.bands[m];
+        const auto  run  = fb[m].begin() + static_cast<std::ptrdiff_t>(band.startBin);
+        sparse.weights.insert(sparse.weights.end(), run, run + static_cast<std::ptrdiff_t>(band.length));
+    }
+
+    return sparse;
+}
+
+
+// Same parameters as melFilterbank(), returned in sparse form.
+inline SparseMelFilterbank sparseMelFilterbank(
+        std::size_t nMelBins,
+        std::size_t nFftBins,
+        double      sampleRate,
+        double      fMin = 20.0,
+        double      fMax = -1.0)   // -1 → nyquist
+{
+    return makeSparse(melFilterbank(nMelBins, nFftBins, sampleRate, fMin, fMax));
+}
+
+inline SparseMelFilterbank sparseMelFilterbank(const FilterbankSettings& settings)
+{
+    return makeSparse(melFilterbank(settings));
+}
+
+
+// Process-wide shared copy of sparseMelFilterbank(settings).
+// Each distinct settings value is built once, on first request, and kept for
+// the lifetime of the program, so every analyser with the same settings
+// shares one immutable table and the reference never dangles.
+// Thread-safe: filterbanks are built outside the lock, so a first build never
+// blocks lookups of other settings, but the lookup itself still locks, so
+// call it at construction time.
+inline const SparseMelFilterbank& cachedMelFilterbank(const FilterbankSettings& settings)
+{
+    static std::mutex mutex;
+    static std::map<FilterbankSettings, std::unique_ptr<const SparseMelFilterbank>> cache;
+
+    {
+        std::lock_guard lock(mutex);
+        if (const auto it = cache.find(settings); it != cache.end())
+            return *it->second;
+    }
+
+    // Threads racing on the same settings build identical filterbanks; the
+    // first one inserted is kept
+    auto filterbank = std::make_unique<const SparseMelFilterbank>(sparseMelFilterbank(settings));
+    std::lock_guard lock(mutex);
+    return *cache.try_emplace(settings, std::move(filterbank)).first->second;
+}
+
+
+// Sparse counterpart of applyMelFilterbank(): only the non-zero run of each
+// band is multiplied, and nothing is allocated.
+inline void applyMelFilterbank(
+        std::span<const float>     fftPowerSpectrum,
+        const SparseMelFilterbank& fb,
+        std::span<float>           dst)
+{
+    tb_instrumentStage(MelApply);
+    assert(dst.size() == fb.numMelBins());
+    assert(fftPowerSpectrum.size() == fb.numFftBins);
+    for (std::size_t m = 0; m < fb.bands.size(); ++m) {
+        const auto&  band   = fb.bands[m];
+        const double energy = simd::dot(fb.bandWeights(m),
+                                        fftPowerSpectrum.subspan(band.startBin, band.length));
+        dst[m] = static_cast<float>(std::log(energy + 1e-9));
+    }
+}
+
+// As above, but with configurable log compression: the band energies are
+// written to dst first, then logCompress() runs over the whole mel vector in
+// one call.
+inline void applyMelFilterbank(
+        std::span<const float>     fftPowerSpectrum,
+        const SparseMelFilterbank& fb,
+        std::span<float>           dst,
+        const LogCompression&      compression)
+{
+    tb_instrumentStage(MelApply);
+    assert(dst.size() == fb.numMelBins());
+    assert(fftPowerSpectrum.size() == fb.numFftBins);
+    for (std::size_t m = 0; m < fb.bands.size(); ++m) {
+        const auto& band = fb.bands[m];
+        dst[m] = static_cast<float>(simd::dot(fb.bandWeights(m),
+                                              fftPowerSpectrum.subspan(band.startBin, band.length)));
+    }
+    logCompress(dst, dst, compression);
+}
+
+
 // ─────────────────────────────────────────────────────────────────────────────
 //  Spectral flux
 //
@@ -101,21 +377,17 @@ inline void applyMelFilterbank(
 //
 //  prev is the magnitude spectrum from the previous frame.
 //  curr is the current magnitude spectrum.
-//  After the call prev should be updated to curr by the caller.
+//  After the call prev should be updated to curr by the caller
+//  (SpectralFluxTracker in tb_OnsetDetection.h keeps that state itself).
 // ─────────────────────────────────────────────────────────────────────────────
 
 inline float spectralFlux(
         std::span<const float> prev,
         std::span<const float> curr)
 {
+    tb_instrumentStage(SpectralFlux);
     assert(prev.size() == curr.size());
-    double flux = 0.0;
-    for (std::size_t i = 0; i < curr.size(); ++i) {
-        const double diff = curr[i] - prev[i];
-        if (diff > 0.0)
-            flux += diff;
-    }
-    return static_cast<float>(flux);
+    return static_cast<float>(simd::positiveDifferenceSum(prev, curr));
 }
 
 
@@ -125,9 +397,7 @@ inline float spectralFlux(
 
 inline float rmsEnergy(std::span<const float> samples)
 {
-    double sum = 0.0;
-    for (float s : samples)
-        sum += static_cast<double>(s) * s;
+    const double sum = simd::sumOfSquares(samples);
     return static_cast<float>(std::sqrt(sum / samples.size()));
 }
 
@@ -136,21 +406,152 @@ inline float rmsEnergy(std::span<const float> samples)
 //  Spectral centroid  (kept for reference / offline analysis)
 // ─────────────────────────────────────────────────────────────────────────────
 
-static float spectralCentroid(std::span<const float> fftPowerSpectrum, double sampleRate) {
+inline float spectralCentroid(std::span<const float> fftPowerSpectrum, double sampleRate) {
+    tb_instrumentStage(SpectralCentroid);
     const double freqResolution = sampleRate / (2.0 * (fftPowerSpectrum.size() - 1));
 
-    double weightedSum  = 0.0;
-    double magnitudeSum = 0.0;
-
-    for (size_t i = 0; i < fftPowerSpectrum.size(); ++i) {
-        double frequency = i * freqResolution;
-        weightedSum  += frequency * fftPowerSpectrum[i];
-        magnitudeSum += fftPowerSpectrum[i];
-    }
+    const auto   moments      = simd::indexMoments(fftPowerSpectrum);
+    const double weightedSum  = moments.indexWeightedSum * freqResolution;
+    const double magnitudeSum = moments.sum;
 
     return magnitudeSum != 0.0
         ? static_cast<float>(weightedSum / magnitudeSum)
         : 0.f;
 }
 
-} // namespace tb
\ No newline at end of file
+
+// ─────────────────────────────────────────────────────────────────────────────
+//  Batched features
+//
+//  Multi-frame variants for offline analysis.  Every frame matrix is
+//  contiguous and row-major (nFrames × frameLength), and every output holds
+//  one row / value per frame, so a whole spectrogram is processed per call.
+// ─────────────────────────────────────────────────────────────────────────────
+
+namespace detail {
+
+// Number of frames of `frameLength` floats that fit in ~64 KiB, so a tile of
+// frames stays in L1/L2 while every filterbank band sweeps across it.
+inline std::size_t framesPerTile(std::size_t frameLength)
+{
+    constexpr std::size_t tileBytes = 64 * 1024;
+    return std::clamp<std::size_t>(tileBytes / (frameLength * sizeof(float)), 1, 64);
+}
+
+} // namespace detail
+
+
+// Batched sparse applyMelFilterbank().
+// spectrogram is (nFrames × fb.numFftBins), dst is (nFrames × fb.numMelBins()).
+// Frames are processed in cache-sized tiles with the band loop outermost, so
+// each band's weights are reused across every frame of the tile.
+inline void applyMelFilterbankBatch(
+        std::span<const float>     spectrogram,
+        const SparseMelFilterbank& fb,
+        std::span<float>           dst)
+{
+    const std::size_t nBins    = fb.numFftBins;
+    const std::size_t nMelBins = fb.numMelBins();
+    assert(nBins > 0 && spectrogram.size() % nBins == 0);
+    const std::size_t nFrames  = spectrogram.size() / nBins;
+    assert(dst.size() == nFrames * nMelBins);
+
+    const std::size_t tile = detail::framesPerTile(nBins);
+    for (std::size_t first = 0; first < nFrames; first += tile) {
+        const std::size_t last = std::min(nFrames, first + tile);
+        for (std::size_t m = 0; m < nMelBins; ++m) {
+            const auto& band    = fb.bands[m];
+            const auto  weights = fb.bandWeights(m);
+            for (std::size_t f = first; f < last; ++f) {
+                const auto   frame  = spectrogram.subspan(f * nBins + band.startBin, band.length);
+                const double energy = simd::dot(weights, frame);
+                dst[f * nMelBins + m] = static_cast<float>(std::log(energy + 1e-9));
+            }
+        }
+    }
+}
+
+// Batched applyMelFilterbank() with configurable log compression, applied to
+// each tile of frames in one logCompress() call while it is still in cache.
+inline void applyMelFilterbankBatch(
+        std::span<const float>     spectrogram,
+        const SparseMelFilterbank& fb,
+        std::span<float>           dst,
+        const LogCompression&      compression)
+{
+    const std::size_t nBins    = fb.numFftBins;
+    const std::size_t nMelBins = fb.numMelBins();
+    assert(nBins > 0 && spectrogram.size() % nBins == 0);
+    const std::size_t nFrames  = spectrogram.size() / nBins;
+    assert(dst.size() == nFrames * nMelBins);
+
+    const std::size_t tile = detail::framesPerTile(nBins);
+    for (std::size_t first = 0; first < nFrames; first += tile) {
+        const std::size_t last = std::min(nFrames, first + tile);
+        for (std::size_t m = 0; m < nMelBins; ++m) {
+            const auto& band    = fb.bands[m];
+            const auto  weights = fb.bandWeights(m);
+            for (std::size_t f = first; f < last; ++f) {
+                const auto frame = spectrogram.subspan(f * nBins + band.startBin, band.length);
+                dst[f * nMelBins + m] = static_cast<float>(simd::dot(weights, frame));
+            }
+        }
+
+        const auto energies = dst.subspan(first * nMelBins, (last - first) * nMelBins);
+        logCompress(energies, energies, compression);
+    }
+}
+
+
+// Batched spectralFlux() over (nFrames × nBins) magnitude spectra.
+// dst[f] is the flux from frame f-1 to frame f.  For f == 0 the flux is taken
+// against previousFrame (e.g. the last frame of the preceding batch), or is 0
+// when previousFrame is empty.
+inline void spectralFluxBatch(
+        std::span<const float> magnitudes,
+        std::size_t            nBins,
+        std::span<float>       dst,
+        std::span<const float> previousFrame = {})
+{
+    assert(nBins > 0 && magnitudes.size() % nBins == 0);
+    const std::size_t nFrames = magnitudes.size() / nBins;
+    assert(dst.size() == nFrames);
+    assert(previousFrame.empty() || previousFrame.size() == nBins);
+
+    for (std::size_t f = 0; f < nFrames; ++f) {
+        const auto curr = magnitudes.subspan(f * nBins, nBins);
+        if (f > 0)
+            dst[f] = spectralFlux(magnitudes.subspan((f - 1) * nBins, nBins), curr);
+        else
+            dst[f] = previousFrame.empty() ? 0.f : spectralFlux(previousFrame, curr);
+    }
+}
+
+
+// Batched spectralCentroid() over (nFrames × nBins) power spectra.
+inline void spectralCentroidBatch(
+        std::span<const float> powerSpectra,
+        std::size_t            nBins,
+        double                 sampleRate,
+        std::span<float>       dst)
+{
+    assert(nBins > 1 && powerSpectra.size() % nBins == 0);
+    assert(dst.size() == powerSpectra.size() / nBins);
+    for (std::size_t f = 0; f < dst.size(); ++f)
+        dst[f] = spectralCentroid(powerSpectra.subspan(f * nBins, nBins), sampleRate);
+}
+
+
+// Batched rmsEnergy() over (nFrames × frameSize) time-domain frames.
+inline void rmsEnergyBatch(
+        std::span<const float> frames,
+        std::size_t            frameSize,
+        std::span<float>       dst)
+{
+    assert(frameSize > 0 && frames.size() % frameSize == 0);
+    assert(dst.size() == frames.size() / frameSize);
+    for (std::size_t f = 0; f < dst.size(); ++f)
+        dst[f] = rmsEnergy(frames.subspan(f * frameSize, frameSize));
+}
+
+} // namespace tb
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "tb_Core.h"
+
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Radix-2 FFT for real input of a fixed power-of-two size.
+ *
+ * The real frame is packed into a half-size complex FFT and split afterwards, so a forward
+ * transform costs roughly one complex FFT of size/2. Twiddles, the bit-reversal table and the
+ * working buffer are all allocated in the constructor; forward() never allocates.
+ *
+ * An instance owns its scratch memory, so use one instance per thread.
+ */
+class Fft {
+  public:
+    /**
+     * @param size Transform size (must be a power of two and >= 4)
+     */
+    explicit Fft(int size) : mSize(size) {
+        tb_throwMsgIf(size < 4 || (size & (size - 1)) != 0, "FFT size must be a power of two >= 4");
+
+        constexpr auto pi = std::numbers::pi;
+        const auto half = size / 2;
+
+        mTwiddles.resize(half / 2);
+        for (int k = 0; k < half / 2; ++k)
+            mTwiddles[k] = std::polar(1.0f, static_cast<float>(-2.0 * pi * k / half));
+
+        mSplitTwiddles.resize(half + 1);
+        for (int k = 0; k <= half; ++k)
+            mSplitTwiddles[k] = std::polar(1.0f, static_cast<float>(-2.0 * pi * k / size));
+
+        mBitReverse.resize(half);
+        int bits = 0;
+        while ((1 << bits) < half)
+            ++bits;
+        for (int i = 0; i < half; ++i) {
+            int reversed = 0;
+            for (int b = 0; b < bits; ++b)
+                reversed |= ((i >> b) & 1) << (bits - 1 - b);
+            mBitReverse[i] = reversed;
+        }
+
+        mScratch.resize(half);
+    }
+
+    int size() const noexcept { return mSize; }
+
+    /**
+     * @return The number of bins in a one-sided spectrum (size / 2 + 1)
+     */
+    int numBins() const noexcept { return mSize / 2 + 1; }
+
+    /**
+     * Computes the one-sided spectrum of a real frame.
+     *
+     * @param input Real input with size() samples
+     * @param output Complex output with numBins() elements
+     */
+    void forward(std::span<const float> input, std::span<std::complex<float>> output) {
+        tb_assert(static_cast<int>(input.size()) == mSize);
+        tb_assert(static_cast<int>(output.size()) == numBins());
+
+        const auto half = mSize / 2;
+
+        // Pack even/odd samples as real/imaginary parts, in bit-reversed order
+        for (int i = 0; i < half; ++i) {
+            const auto j = mBitReverse[i];
+            mScratch[j] = { input[2 * i], input[2 * i + 1] };
+        }
+
+        // Iterative radix-2 butterflies
+        for (int length = 2; length <= half; length *= 2) {
+            const auto stride = half / length;
+            for (int start = 0; start < half; start += length) {
+                for (int k = 0; k < length / 2; ++k) {
+                    const auto a = mScratch[start + k];
+                    const auto b = mScratch[start + k + length / 2] * mTwiddles[k * stride];
+                    mScratch[start + k] = a + b;
+                    mScratch[start + k + length / 2] = a - b;
+                }
+            }
+        }
+
+        // Split the half-size complex spectrum into the real spectrum
+        for (int k = 0; k <= half; ++k) {
+            const auto zk = mScratch[k == half ? 0 : k];
+            const auto zn = std::conj(mScratch[k == 0 ? 0 : half - k]);
+            const auto even = 0.5f * (zk + zn);
+            const auto odd = std::complex<float>(0.f, -0.5f) * (zk - zn);
+            output[k] = even + mSplitTwiddles[k] * odd;
+        }
+    }
+
+    /**
+     * Computes the one-sided power spectrum (|X|²) of a real frame.
+     *
+     * @param input Real input with size() samples
+     * @param spectrum Scratch space with numBins() elements, overwritten with the complex spectrum
+     * @param power Output with numBins() elements
+     */
+    void powerSpectrum(std::span<const float> input, std::span<std::complex<float>> spectrum,
+                       std::span<float> power) {
+        tb_assert(power.size() == spectrum.size());
+        forward(input, spectrum);
+        for (size_t k = 0; k < spectrum.size(); ++k)
+            power[k] = std::norm(spectrum[k]);
+    }
+
+  private:
+    int mSize = 0;
+    std::vector<std::complex<float>> mTwiddles;
+    std::vector<std::complex<float>> mSplitTwiddles;
+    std::vector<int> mBitReverse;
+    std::vector<std::complex<float>> mScratch;
+
+  public:
+    Fft(const Fft&) = delete;
+    Fft& operator=(const Fft&) = delete;
+};
+
+}
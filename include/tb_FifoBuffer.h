@@ -2,8 +2,11 @@
 #pragma once
 
 #include "tb_Core.h"
+#include "tb_Instrumentation.h"
 
+#include <atomic>
 #include <choc_SampleBuffers.h>
+#include <cstdint>
 
 namespace tb {
 
@@ -20,6 +23,7 @@ class FifoBuffer {
     choc::buffer::ChannelArrayView<T> getBuffer() const noexcept { return mBuffer.getStart(mSize); }
 
     choc::buffer::ChannelArrayView<T> push(choc::buffer::ChannelArrayView<T> const& buffer) {
+        tb_instrumentStage(FifoPush);
         tb_assert(buffer.getNumChannels() == mBuffer.getNumChannels());
 
         const auto framesToWrite = std::min(freeSpace(), static_cast<int>(buffer.getNumFrames()));
@@ -28,7 +32,22 @@ class FifoBuffer {
         return buffer.fromFrame(framesToWrite);
     }
 
+    /**
+     * The free space after the stored frames, for writing in place (e.g. with deinterleave()).
+     * Call commitWrite() afterwards
+     */
+    choc::buffer::ChannelArrayView<T> getWritableRegion() const noexcept { return mBuffer.fromFrame(mSize); }
+
+    /**
+     * Appends numFrames frames written through getWritableRegion()
+     */
+    void commitWrite(int numFrames) noexcept {
+        tb_assert(numFrames >= 0 && numFrames <= freeSpace());
+        mSize += numFrames;
+    }
+
     void pop(int numFramesToPop) {
+        tb_instrumentStage(FifoPop);
         const auto framesToPop = std::min(numFramesToPop, mSize);
         if (framesToPop <= 0)
             return;
@@ -53,4 +72,129 @@ public:
     FifoBuffer& operator=(const FifoBuffer&) = delete;
 };
 
+/**
+ * Wrap-around variant of FifoBuffer for one producer thread and one consumer thread.
+ *
+ * Reads and writes never move data: the read and write positions are atomic and wrap around the
+ * storage, so pop() is O(1). Both sides can work directly in the buffer through
+ * getWritableRegions()/commitWrite() and getReadableRegions()/pop(), each of which exposes up to
+ * two contiguous views (the second one is non-empty when the region wraps).
+ *
+ * push(), getWritableRegions() and commitWrite() may only be called from the producer thread;
+ * getReadableRegions() and pop() only from the consumer thread. clear() requires both to be idle.
+ */
+template<typename T>
+class SpscFifoBuffer {
+  public:
+    SpscFifoBuffer(int numChannels, int numFrames) : mBuffer(numChannels, numFrames) {
+        tb_throwIf(numFrames <= 0);
+        clear();
+    }
+
+    struct Regions {
+        choc::buffer::ChannelArrayView<T> first;
+        choc::buffer::ChannelArrayView<T> second;
+
+        int getNumFrames() const noexcept {
+            return static_cast<int>(first.getNumFrames() + second.getNumFrames());
+        }
+    };
+
+    int capacity() const noexcept { return static_cast<int>(mBuffer.getNumFrames()); }
+
+    // These are snapshots, exact only when called from the producer or consumer thread
+    int size() const noexcept {
+        return static_cast<int>(mWritePos.load(std::memory_order_acquire) -
+                                mReadPos.load(std::memory_order_acquire));
+    }
+    int freeSpace() const noexcept { return capacity() - size(); }
+    bool isFull() const noexcept { return freeSpace() == 0; }
+
+    /**
+     * Producer: the free space that can be written to, in order. Call commitWrite() afterwards
+     */
+    Regions getWritableRegions() const noexcept {
+        const auto writePos = mWritePos.load(std::memory_order_relaxed);
+        const auto readPos = mReadPos.load(std::memory_order_acquire);
+        return regionsAt(writePos, capacity() - static_cast<int>(writePos - readPos));
+    }
+
+    /**
+     * Producer: publishes numFrames frames written through getWritableRegions()
+     */
+    void commitWrite(int numFrames) noexcept {
+        tb_assert(numFrames >= 0 && numFrames <= freeSpace());
+        mWritePos.store(mWritePos.load(std::memory_order_relaxed) + numFrames,
+                        std::memory_order_release);
+    }
+
+    /**
+     * Producer: copies as much of buffer as fits
+     *
+     * @return The part of buffer that did not fit
+     */
+    choc::buffer::ChannelArrayView<T> push(choc::buffer::ChannelArrayView<T> const& buffer) {
+        tb_instrumentStage(FifoPush);
+        tb_assert(buffer.getNumChannels() == mBuffer.getNumChannels());
+
+        const auto regions = getWritableRegions();
+        const auto framesToWrite = std::min(regions.getNumFrames(), static_cast<int>(buffer.getNumFrames()));
+        const auto firstFrames = std::min(framesToWrite, static_cast<int>(regions.first.getNumFrames()));
+        choc::buffer::copyIntersection(regions.first, buffer.getStart(firstFrames));
+        choc::buffer::copyIntersection(regions.second,
+                                       buffer.getFrameRange({ static_cast<uint32_t>(firstFrames),
+                                                              static_cast<uint32_t>(framesToWrite) }));
+        commitWrite(framesToWrite);
+        return buffer.fromFrame(framesToWrite);
+    }
+
+    /**
+     * Consumer: the frames available for reading, oldest first. Call pop() once consumed
+     */
+    Regions getReadableRegions() const noexcept {
+        const auto readPos = mReadPos.load(std::memory_order_relaxed);
+        const auto writePos = mWritePos.load(std::memory_order_acquire);
+        return regionsAt(readPos, static_cast<int>(writePos - readPos));
+    }
+
+    /**
+     * Consumer: releases up to numFramesToPop of the oldest frames
+     */
+    void pop(int numFramesToPop) noexcept {
+        tb_instrumentStage(FifoPop);
+        const auto readPos = mReadPos.load(std::memory_order_relaxed);
+        const auto available = static_cast<int>(mWritePos.load(std::memory_order_acquire) - readPos);
+        const auto framesToPop = std::min(numFramesToPop, available);
+        if (framesToPop <= 0)
+            return;
+
+        mReadPos.store(readPos + framesToPop, std::memory_order_release);
+    }
+
+    void clear() {
+        mBuffer.clear();  // Just for safety
+        mReadPos.store(0, std::memory_order_relaxed);
+        mWritePos.store(0, std::memory_order_release);
+    }
+
+  private:
+    Regions regionsAt(uint64_t position, int numFrames) const noexcept {
+        const auto start = static_cast<int>(position % mBuffer.getNumFrames());
+        const auto firstFrames = std::min(numFrames, capacity() - start);
+        return { .first = mBuffer.getFrameRange({ static_cast<uint32_t>(start),
+                                                  static_cast<uint32_t>(start + firstFrames) }),
+                 .second = mBuffer.getStart(static_cast<uint32_t>(numFrames - firstFrames)) };
+    }
+
+    choc::buffer::ChannelArrayBuffer<T> mBuffer;
+
+    // Free-running positions (never wrapped), on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<uint64_t> mWritePos { 0 };
+    alignas(64) std::atomic<uint64_t> mReadPos { 0 };
+
+public:
+    SpscFifoBuffer(const SpscFifoBuffer&) = delete;
+    SpscFifoBuffer& operator=(const SpscFifoBuffer&) = delete;
+};
+
 }
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "tb_Core.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Optional per-stage timing counters for the library's hot paths.
+ *
+ * Define TB_ENABLE_INSTRUMENTATION=1 (or configure with -DENABLE_INSTRUMENTATION=ON) to compile
+ * them in. When it is 0 (the default), tb_instrumentStage() expands to nothing, so the hooks cost
+ * nothing at all.
+ *
+ * Each thread records into its own slot of a fixed table, claimed with a single compare-exchange
+ * the first time it runs an instrumented stage (call registerCurrentThread() beforehand to keep
+ * even that off the audio callback). Recording is a handful of relaxed atomic operations on
+ * thread-owned cache lines: no locks, no allocation and no contention with the monitoring
+ * thread, which reads every slot with getSnapshot(). When a thread exits, its counts are folded
+ * into a shared retired slot and its own slot is released for reuse, so thread churn (pool
+ * restarts, per-file workers) does not use the table up. Only threads beyond kMaxThreads alive
+ * at the same time record into the shared slot, which stays correct but may contend.
+ *
+ * Times are measured with std::chrono::steady_clock in nanoseconds.
+ */
+
+#ifndef TB_ENABLE_INSTRUMENTATION
+#define TB_ENABLE_INSTRUMENTATION 0
+#endif
+
+namespace tb::instrumentation {
+
+enum class Stage {
+    SrcProcess,        // SampleRateConverter::process() / processInterleaved()
+    FifoPush,          // FifoBuffer / SpscFifoBuffer push()
+    FifoPop,           // FifoBuffer / SpscFifoBuffer pop()
+    MelApply,          // applyMelFilterbank()
+    SpectralFlux,      // spectralFlux()
+    SpectralCentroid,  // spectralCentroid()
+    NumStages
+};
+
+inline constexpr std::size_t kNumStages = static_cast<std::size_t>(Stage::NumStages);
+inline constexpr std::size_t kMaxThreads = 64;
+
+/**
+ * @return A stable, metrics-friendly name for the stage, e.g. "src_process"
+ */
+inline const char* getStageName(Stage stage) noexcept {
+    switch (stage) {
+    case Stage::SrcProcess: return "src_process";
+    case Stage::FifoPush: return "fifo_push";
+    case Stage::FifoPop: return "fifo_pop";
+    case Stage::MelApply: return "mel_apply";
+    case Stage::SpectralFlux: return "spectral_flux";
+    case Stage::SpectralCentroid: return "spectral_centroid";
+    case Stage::NumStages: break;
+    }
+    return "unknown";
+}
+
+struct StageStats {
+    uint64_t calls = 0;
+    uint64_t totalNanoseconds = 0;
+    uint64_t maxNanoseconds = 0;  // Longest single call
+};
+
+using Snapshot = std::array<StageStats, kNumStages>;
+
+namespace detail {
+
+struct alignas(64) Counter {
+    std::atomic<uint64_t> calls { 0 };
+    std::atomic<uint64_t> totalNanoseconds { 0 };
+    std::atomic<uint64_t> maxNanoseconds { 0 };
+};
+
+struct ThreadSlot {
+    std::atomic<bool> claimed { false };
+    std::array<Counter, kNumStages> counters;
+};
+
+inline std::array<ThreadSlot, kMaxThreads> gSlots;
+
+// Counts of exited threads, and the slot of threads that found the table full
+inline ThreadSlot gSharedSlot;
+
+inline thread_local ThreadSlot* tSlot = nullptr;
+
+inline void mergeInto(Counter& dst, uint64_t calls, uint64_t totalNanoseconds, uint64_t maxNanoseconds) noexcept {
+    dst.calls.fetch_add(calls, std::memory_order_relaxed);
+    dst.totalNanoseconds.fetch_add(totalNanoseconds, std::memory_order_relaxed);
+
+    auto max = dst.maxNanoseconds.load(std::memory_order_relaxed);
+    while (maxNanoseconds > max &&
+           ! dst.maxNanoseconds.compare_exchange_weak(max, maxNanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+// Owns a claimed slot for the lifetime of its thread. Only touched when the slot is claimed, so
+// recording itself never goes through the thread_local destructor machinery.
+struct SlotOwner {
+    ThreadSlot* slot = nullptr;
+
+    ~SlotOwner() {
+        // Counts are taken out before they are added back, so a concurrent snapshot may briefly
+        // miss them but never sees them twice
+        for (std::size_t s = 0; s < kNumStages; ++s) {
+            auto& counter = slot->counters[s];
+            mergeInto(gSharedSlot.counters[s], counter.calls.exchange(0, std::memory_order_relaxed),
+                      counter.totalNanoseconds.exchange(0, std::memory_order_relaxed),
+                      counter.maxNanoseconds.exchange(0, std::memory_order_relaxed));
+        }
+
+        // Anything recorded later in this thread's teardown goes to the shared slot
+        tSlot = &gSharedSlot;
+        slot->claimed.store(false, std::memory_order_release);
+    }
+};
+
+inline thread_local SlotOwner tSlotOwner;
+
+inline ThreadSlot& currentSlot() noexcept {
+    if (tSlot == nullptr) {
+        tSlot = &gSharedSlot;
+        for (auto& slot : gSlots) {
+            bool expected = false;
+            if (slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                tSlot = &slot;
+                tSlotOwner.slot = &slot;
+                break;
+            }
+        }
+    }
+    return *tSlot;
+}
+
+}
+
+/**
+ * Claims this thread's counter slot now rather than on its first instrumented call
+ */
+inline void registerCurrentThread() noexcept { detail::currentSlot(); }
+
+/**
+ * Adds one call of `nanoseconds` to the calling thread's counters for `stage`
+ */
+inline void record(Stage stage, uint64_t nanoseconds) noexcept {
+    detail::mergeInto(detail::currentSlot().counters[static_cast<std::size_t>(stage)], 1, nanoseconds, nanoseconds);
+}
+
+/**
+ * Sums every thread's counters. Safe to call from any thread at any time; it never blocks the
+ * threads doing the recording. Each counter is read atomically, but a call that is being
+ * recorded while the snapshot runs may be only partly included.
+ */
+inline Snapshot getSnapshot() noexcept {
+    Snapshot snapshot {};
+    auto addSlot = [&](const detail::ThreadSlot& slot) {
+        for (std::size_t s = 0; s < kNumStages; ++s) {
+            const auto& counter = slot.counters[s];
+            auto& stats = snapshot[s];
+            stats.calls += counter.calls.load(std::memory_order_relaxed);
+            stats.totalNanoseconds += counter.totalNanoseconds.load(std::memory_order_relaxed);
+            stats.maxNanoseconds = std::max(stats.maxNanoseconds, counter.maxNanoseconds.load(std::memory_order_relaxed));
+        }
+    };
+
+    for (const auto& slot : detail::gSlots)
+        addSlot(slot);
+    addSlot(detail::gSharedSlot);
+    return snapshot;
+}
+
+/**
+ * Zeroes every counter (slots stay claimed). Calls recorded concurrently may be partly lost;
+ * for continuous export prefer diffing successive snapshots.
+ */
+inline void reset() noexcept {
+    auto resetSlot = [](detail::ThreadSlot& slot) {
+        for (auto& counter : slot.counters) {
+            counter.calls.store(0, std::memory_order_relaxed);
+            counter.totalNanoseconds.store(0, std::memory_order_relaxed);
+            counter.maxNanoseconds.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    for (auto& slot : detail::gSlots)
+        resetSlot(slot);
+    resetSlot(detail::gSharedSlot);
+}
+
+/**
+ * Times its own lifetime and records it against a stage
+ */
+class ScopedTimer {
+  public:
+    explicit ScopedTimer(Stage stage) noexcept : mStage(stage), mStart(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - mStart;
+        record(mStage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    Stage mStage;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+}
+
+#define tb_instrumentConcatImpl(_A, _B) _A##_B
+#define tb_instrumentConcat(_A, _B) tb_instrumentConcatImpl(_A, _B)
+
+#if TB_ENABLE_INSTRUMENTATION
+#define tb_instrumentStage(_STAGE)                                                                                     \
+    const ::tb::instrumentation::ScopedTimer tb_instrumentConcat(tb_scopedTimer_, __LINE__)(                           \
+        ::tb::instrumentation::Stage::_STAGE)
+#else
+#define tb_instrumentStage(_STAGE) static_cast<void>(0)
+#endif
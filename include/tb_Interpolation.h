@@ -2,16 +2,109 @@
 #pragma once
 
 #include "tb_Core.h"
+#include "tb_Simd.h"
 #include "tb_Space.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace tb::catmullRom {
 
+/**
+ * Knot spacing of the spline: the parameter interval between two control points is their
+ * distance raised to alpha. Centripetal never forms cusps or self-intersections within a segment,
+ * and follows sharp turns more tightly than Uniform.
+ */
 enum class Type {
-    Uniform
+    Uniform,      // alpha = 0
+    Centripetal,  // alpha = 0.5
+    Chordal       // alpha = 1
 };
 
+namespace detail {
+
+/**
+ * Segment p1 → p2 of a Catmull-Rom spline as a cubic in u ∈ [0, 1], so that any number of points
+ * can be evaluated on it with Horner's rule.
+ *
+ * For the non-uniform types this is the cubic Hermite form of the Barry-Goldman pyramid, with the
+ * tangents taken from the knot intervals.
+ */
+struct Segment {
+    Segment(Point p0, Point p1, Point p2, Point p3, Type type) {
+        if (type == Type::Uniform) {
+            setCoefficients(p1, p2, 0.5 * (p2.x - p0.x), 0.5 * (p2.y - p0.y), 0.5 * (p3.x - p1.x),
+                            0.5 * (p3.y - p1.y));
+            return;
+        }
+
+        const auto alpha = type == Type::Centripetal ? 0.5 : 1.0;
+        const auto interval = [alpha](Point a, Point b) {
+            // Coincident control points would give an empty interval
+            const auto distance = std::hypot(static_cast<double>(b.x) - a.x, static_cast<double>(b.y) - a.y);
+            return std::max(std::pow(distance, alpha), 1e-6);
+        };
+        const auto dt0 = interval(p0, p1);
+        const auto dt1 = interval(p1, p2);
+        const auto dt2 = interval(p2, p3);
+
+        // Tangents at p1 and p2, scaled to the p1 → p2 interval
+        const auto tangent = [dt1](double a, double b, double c, double dtA, double dtB) {
+            return dt1 * ((b - a) / dtA - (c - a) / (dtA + dtB) + (c - b) / dtB);
+        };
+        setCoefficients(p1, p2, tangent(p0.x, p1.x, p2.x, dt0, dt1), tangent(p0.y, p1.y, p2.y, dt0, dt1),
+                        tangent(p1.x, p2.x, p3.x, dt1, dt2), tangent(p1.y, p2.y, p3.y, dt1, dt2));
+    }
+
+    Point at(double u) const {
+        return Point(static_cast<float>(((x[0] * u + x[1]) * u + x[2]) * u + x[3]),
+                     static_cast<float>(((y[0] * u + y[1]) * u + y[2]) * u + y[3]));
+    }
+
+    /**
+     * @return The u in [0, 1] at which x(u) = target, for a segment running from lower to higher
+     *         x. Newton's method, falling back to bisection whenever a step leaves the bracket
+     */
+    double solveForX(double target) const {
+        const auto xStart = x[3];
+        const auto xEnd = x[0] + x[1] + x[2] + x[3];
+        if (target <= xStart)
+            return 0.0;
+        if (target >= xEnd)
+            return 1.0;
+
+        double lo = 0.0, hi = 1.0;
+        auto u = (target - xStart) / (xEnd - xStart);
+        for (int iteration = 0; iteration < 20; ++iteration) {
+            const auto error = ((x[0] * u + x[1]) * u + x[2]) * u + x[3] - target;
+            if (std::abs(error) <= 1e-9 * (xEnd - xStart))
+                break;
+            (error < 0.0 ? lo : hi) = u;
+
+            const auto slope = (3.0 * x[0] * u + 2.0 * x[1]) * u + x[2];
+            const auto next = u - error / slope;
+            u = next > lo && next < hi ? next : 0.5 * (lo + hi);
+        }
+        return u;
+    }
+
+    std::array<double, 4> x {};  // Cubic coefficients, highest power first
+    std::array<double, 4> y {};
+
+  private:
+    void setCoefficients(Point p1, Point p2, double m1x, double m1y, double m2x, double m2y) {
+        x = { 2.0 * p1.x - 2.0 * p2.x + m1x + m2x, -3.0 * p1.x + 3.0 * p2.x - 2.0 * m1x - m2x, m1x, p1.x };
+        y = { 2.0 * p1.y - 2.0 * p2.y + m1y + m2y, -3.0 * p1.y + 3.0 * p2.y - 2.0 * m1y - m2y, m1y, p1.y };
+    }
+};
+
+}
+
 /**
  * @brief Calculates the size needed for the output line when calling `spline`
  *
@@ -95,8 +188,273 @@ inline void spline(std::vector<Point>& outLine, const std::vector<Point>& inLine
 
         tb_assert(outIdx == outLine.size() - 1);
         outLine[outIdx] = inLine[inLine.size() - 2]; // Add last existing point
-    } else
-        tb_assert(false); // Not implemented/supported
+    } else {
+        std::size_t outIdx = 0;
+        for (std::size_t i = 1; i + 2 < inLine.size(); ++i) {
+            const detail::Segment segment(inLine[i - 1], inLine[i], inLine[i + 1], inLine[i + 2], type);
+
+            outLine[outIdx++] = inLine[i];
+            for (int j = 1; j <= interpolationSteps; ++j)
+                outLine[outIdx++] = segment.at(static_cast<double>(j) / (interpolationSteps + 1));
+        }
+
+        tb_assert(outIdx == outLine.size() - 1);
+        outLine[outIdx] = inLine[inLine.size() - 2];
+    }
+}
+
+namespace detail {
+
+// Shared by the sample() overloads; inLine is anything with size() and operator[] returning Point
+template<typename ControlPoints, typename Store>
+void sample(const ControlPoints& inLine, std::span<const float> positions, Type type, Store store) {
+    tb_assert(inLine.size() >= 4);
+
+    const auto first = 1.0;
+    const auto last = static_cast<double>(inLine.size() - 2);
+    const auto lastSegment = inLine.size() - 4;  // Segment s runs from inLine[s + 1] to inLine[s + 2]
+
+    std::size_t s = 0;
+    Segment segment(inLine[0], inLine[1], inLine[2], inLine[3], type);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        tb_assert(i == 0 || positions[i] >= positions[i - 1]);
+        const auto position = std::clamp(static_cast<double>(positions[i]), first, last);
+
+        const auto target = std::min(static_cast<std::size_t>(position - first), lastSegment);
+        if (target != s) {
+            s = target;
+            segment = Segment(inLine[s], inLine[s + 1], inLine[s + 2], inLine[s + 3], type);
+        }
+        store(i, segment.at(position - first - static_cast<double>(s)));
+    }
+}
+
+// Shared by the sampleAtX() overloads
+template<typename ControlPoints, typename Store>
+void sampleAtX(const ControlPoints& inLine, std::span<const float> xValues, Type type, Store store) {
+    tb_assert(inLine.size() >= 4);
+
+    const auto lastSegment = inLine.size() - 4;  // Segment s runs from inLine[s + 1] to inLine[s + 2]
+
+    std::size_t s = 0;
+    Segment segment(inLine[0], inLine[1], inLine[2], inLine[3], type);
+    for (std::size_t i = 0; i < xValues.size(); ++i) {
+        tb_assert(i == 0 || xValues[i] >= xValues[i - 1]);
+
+        auto target = s;
+        while (target < lastSegment && inLine[target + 2].x < xValues[i])
+            ++target;
+        if (target != s) {
+            s = target;
+            segment = Segment(inLine[s], inLine[s + 1], inLine[s + 2], inLine[s + 3], type);
+        }
+        store(i, segment.at(segment.solveForX(xValues[i])));
+    }
+}
+
 }
 
-}
\ No newline at end of file
+/**
+ * @brief Evaluates the spline at arbitrary positions in one pass
+ *
+ * Positions are in control point units: position i + u (0 <= u <= 1) lies a fraction u of the
+ * way, in spline parameter, from inLine[i] to inLine[i + 1]. The positions must be sorted
+ * ascending; the segment is then found by a cursor that only moves forward, and its cubic is
+ * rebuilt only when the cursor enters a new segment. Positions outside [1, inLine.size() - 2]
+ * are clamped to the drawn part of the curve.
+ *
+ * For Type::Uniform and control points evenly spaced in x (spectrum bins, samples), x is linear
+ * in the position, so pixel column c at x(c) maps to position 1 + (x(c) - inLine[1].x) / spacing.
+ * That does not hold for the other types (their knot intervals follow the distances between
+ * points, so x(u) is not linear even for evenly spaced x), nor for unevenly spaced x such as
+ * log-frequency spectra; use sampleAtX() there.
+ *
+ * @param out One point per position
+ * @param inLine Control points (must have >= 4 points)
+ * @param positions Ascending positions to evaluate at
+ * @param type The sub-variant of Catmull-Rom to use
+ */
+inline void sample(std::span<Point> out, std::span<const Point> inLine, std::span<const float> positions,
+                   Type type) {
+    tb_assert(out.size() == positions.size());
+    detail::sample(inLine, positions, type, [&](std::size_t i, Point p) { out[i] = p; });
+}
+
+/**
+ * @brief sample() for structure-of-arrays points, e.g. PointBuffer
+ */
+inline void sample(PointSpan out, ConstPointSpan inLine, std::span<const float> positions, Type type) {
+    tb_assert(out.size() == positions.size());
+    detail::sample(inLine, positions, type, [&](std::size_t i, Point p) {
+        out.x[i] = p.x;
+        out.y[i] = p.y;
+    });
+}
+
+/**
+ * @brief Evaluates the spline at the points where it crosses given x values, in one pass
+ *
+ * For curves that are functions of x, e.g. a spectrum over log-spaced frequencies drawn at one
+ * point per pixel column. The control points must be strictly ascending in x and the x values
+ * sorted ascending: a segment cursor then moves forward while the next control point lies left
+ * of the query, and each query solves x(u) = x on its segment. x values outside
+ * [inLine[1].x, inLine[inLine.size() - 2].x] are clamped to the ends of the drawn curve.
+ *
+ * @param out One point per x value
+ * @param inLine Control points (must have >= 4 points)
+ * @param xValues Ascending x values to evaluate at
+ * @param type The sub-variant of Catmull-Rom to use
+ */
+inline void sampleAtX(std::span<Point> out, std::span<const Point> inLine, std::span<const float> xValues,
+                      Type type) {
+    tb_assert(out.size() == xValues.size());
+    detail::sampleAtX(inLine, xValues, type, [&](std::size_t i, Point p) { out[i] = p; });
+}
+
+/**
+ * @brief sampleAtX() for structure-of-arrays points, e.g. PointBuffer
+ */
+inline void sampleAtX(PointSpan out, ConstPointSpan inLine, std::span<const float> xValues, Type type) {
+    tb_assert(out.size() == xValues.size());
+    detail::sampleAtX(inLine, xValues, type, [&](std::size_t i, Point p) {
+        out.x[i] = p.x;
+        out.y[i] = p.y;
+    });
+}
+
+/**
+ * Precomputed uniform Catmull-Rom basis weights for a fixed number of interpolation steps.
+ *
+ * Output point j of a segment (j = 0 being the segment's first control point itself) is
+ * w[0] · p0 + w[1] · p1 + w[2] · p2 + w[3] · p3, and the weights only depend on j and
+ * interpolationSteps. Build one per step count and reuse it for every curve and frame.
+ */
+class UniformBasis {
+  public:
+    explicit UniformBasis(int interpolationSteps) : mInterpolationSteps(interpolationSteps) {
+        tb_throwIf(interpolationSteps <= 0);
+
+        const auto pointsPerSegment = static_cast<std::size_t>(interpolationSteps) + 1;
+        const auto lanes = simd::kCubicLanes;
+        for (auto& weights : mWeights)
+            weights.assign((pointsPerSegment + lanes - 1) / lanes * lanes, 0.f);
+
+        for (std::size_t j = 0; j < pointsPerSegment; ++j) {
+            const auto t = static_cast<double>(j) / (interpolationSteps + 1);
+            const auto t2 = t * t;
+            const auto t3 = t2 * t;
+            mWeights[0][j] = static_cast<float>(0.5 * (-t + 2.0 * t2 - t3));
+            mWeights[1][j] = static_cast<float>(0.5 * (2.0 - 5.0 * t2 + 3.0 * t3));
+            mWeights[2][j] = static_cast<float>(0.5 * (t + 4.0 * t2 - 3.0 * t3));
+            mWeights[3][j] = static_cast<float>(0.5 * (-t2 + t3));
+        }
+    }
+
+    int getInterpolationSteps() const noexcept { return mInterpolationSteps; }
+
+    /**
+     * @return The weights of p0..p3 for output point j of a segment, j in [0, interpolationSteps]
+     */
+    std::array<float, 4> getWeights(std::size_t j) const {
+        tb_assert(j <= static_cast<std::size_t>(mInterpolationSteps));
+        return { mWeights[0][j], mWeights[1][j], mWeights[2][j], mWeights[3][j] };
+    }
+
+    /**
+     * @return The weights in the form the tb::simd spline kernels take
+     */
+    simd::CubicWeights getCubicWeights() const {
+        return { { mWeights[0].data(), mWeights[1].data(), mWeights[2].data(), mWeights[3].data() },
+                 static_cast<std::size_t>(mInterpolationSteps) + 1 };
+    }
+
+  private:
+    int mInterpolationSteps = 0;
+    std::array<std::vector<float>, 4> mWeights;  // Per control point, zero-padded to simd::kCubicLanes
+};
+
+/**
+ * @brief Uniform Catmull-Rom spline in float, with the basis weights precomputed
+ *
+ * Produces the same points as spline(outLine, inLine, steps, Type::Uniform) to within float
+ * rounding, writing into caller-provided memory without allocating.
+ *
+ * @param outLine outLineSize(inLine.size(), basis.getInterpolationSteps()) points
+ * @param inLine Control points (must have >= 4 points)
+ */
+inline void spline(std::span<Point> outLine, std::span<const Point> inLine, const UniformBasis& basis) {
+    tb_assert(inLine.size() >= 4);
+    tb_assert(outLine.size() == static_cast<std::size_t>(outLineSize(static_cast<int>(inLine.size()),
+                                                                     basis.getInterpolationSteps())));
+
+    // Point is a pair of floats, so the spans can be handed over as interleaved x, y pairs
+    static_assert(sizeof(Point) == 2 * sizeof(float) && std::is_standard_layout_v<Point>);
+    const auto numSegmentPoints = outLine.size() - 1;
+    simd::cubicSegmentsInterleaved({ reinterpret_cast<const float*>(inLine.data()), 2 * inLine.size() },
+                                   basis.getCubicWeights(),
+                                   { reinterpret_cast<float*>(outLine.data()), 2 * numSegmentPoints });
+    outLine[numSegmentPoints] = inLine[inLine.size() - 2];
+}
+
+/**
+ * @brief Uniform Catmull-Rom spline over separate x and y arrays
+ *
+ * Same as the Point overload, for curves stored as structure-of-arrays, where the control
+ * points of neighbouring segments are contiguous.
+ */
+inline void spline(std::span<float> outX, std::span<float> outY, std::span<const float> inX,
+                   std::span<const float> inY, const UniformBasis& basis) {
+    tb_assert(inX.size() == inY.size() && inX.size() >= 4);
+    tb_assert(outX.size() == outY.size());
+    tb_assert(outX.size() == static_cast<std::size_t>(outLineSize(static_cast<int>(inX.size()),
+                                                                  basis.getInterpolationSteps())));
+
+    const auto numSegmentPoints = outX.size() - 1;
+    simd::cubicSegments(inX, inY, basis.getCubicWeights(), outX.first(numSegmentPoints),
+                        outY.first(numSegmentPoints));
+    outX[numSegmentPoints] = inX[inX.size() - 2];
+    outY[numSegmentPoints] = inY[inY.size() - 2];
+}
+
+/**
+ * @brief uniform spline() for structure-of-arrays points, e.g. PointBuffer
+ */
+inline void spline(PointSpan outLine, ConstPointSpan inLine, const UniformBasis& basis) {
+    spline(outLine.x, outLine.y, inLine.x, inLine.y, basis);
+}
+
+/**
+ * @brief spline() of any Type for structure-of-arrays points, e.g. PointBuffer
+ *
+ * Same points as the std::vector overload to within float rounding, written into caller-provided
+ * memory, so a PointBuffer reused across frames never reallocates. Each segment's cubic is built
+ * once and evaluated with Horner's rule.
+ *
+ * @param outLine outLineSize(inLine.size(), interpolationSteps) points
+ * @param inLine Control points (must have >= 4 points)
+ */
+inline void spline(PointSpan outLine, ConstPointSpan inLine, int interpolationSteps, Type type) {
+    tb_assert(inLine.size() >= 4);
+    tb_assert(interpolationSteps > 0);
+    tb_assert(outLine.size() == static_cast<std::size_t>(outLineSize(static_cast<int>(inLine.size()),
+                                                                     interpolationSteps)));
+
+    const auto store = [&](std::size_t i, Point p) {
+        outLine.x[i] = p.x;
+        outLine.y[i] = p.y;
+    };
+
+    std::size_t outIdx = 0;
+    for (std::size_t i = 1; i + 2 < inLine.size(); ++i) {
+        const detail::Segment segment(inLine[i - 1], inLine[i], inLine[i + 1], inLine[i + 2], type);
+
+        store(outIdx++, inLine[i]);
+        for (int j = 1; j <= interpolationSteps; ++j)
+            store(outIdx++, segment.at(static_cast<double>(j) / (interpolationSteps + 1)));
+    }
+
+    tb_assert(outIdx == outLine.size() - 1);
+    store(outIdx, inLine[inLine.size() - 2]);
+}
+
+}
@@ -3,7 +3,11 @@
 
 #include "tb_Core.h"
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
+#include <cstdint>
+#include <numbers>
 
 namespace tb {
 
@@ -36,4 +40,54 @@ template<typename T>
     return (input - floorPow2 <= ceilingPow2 - input) ? floorPow2 : ceilingPow2;
 }
 
-}
\ No newline at end of file
+namespace detail {
+
+// log2(m) for m in [2/3, 4/3), as f · P(f) with f = m - 1 (Chebyshev fit, |error| < 5e-6)
+inline constexpr float kLog2Poly[] = { 1.44270515f, -0.721356392f, 0.479268521f,
+                                       -0.359242320f, 0.326568902f, -0.273823410f };
+
+// 2^f for f in [0, 1) (minimax fit with P(0) = 1 and P(1) = 2, so integer powers are exact and
+// the result is continuous across them; relative error < 3.4e-6)
+inline constexpr float kExp2Poly[] = { 1.f, 0.693032121f, 0.241379764f,
+                                       0.0520323688f, 0.0135557470f };
+
+// Bit pattern of 2/3: subtracting it before taking the exponent puts the mantissa in [2/3, 4/3)
+inline constexpr int32_t kLog2MantissaOffset = 0x3f2aaaab;
+
+}
+
+/**
+ * log2(x) to within 5e-6 (absolute, before rounding to float), from the exponent bits plus a polynomial on the mantissa.
+ * x must be a positive, normal float; no special values are handled.
+ */
+[[nodiscard]] inline float fastLog2(float x) {
+    const auto bits = std::bit_cast<int32_t>(x);
+    const auto exponent = (bits - detail::kLog2MantissaOffset) >> 23;
+    const auto f = std::bit_cast<float>(bits - (exponent << 23)) - 1.f;
+
+    auto p = detail::kLog2Poly[5];
+    for (int i = 4; i >= 0; --i)
+        p = p * f + detail::kLog2Poly[i];
+    return static_cast<float>(exponent) + f * p;
+}
+
+[[nodiscard]] inline float fastLog(float x) { return fastLog2(x) * std::numbers::ln2_v<float>; }
+
+/**
+ * 2^x to within 4e-6 (relative), exact for integer x. x is clamped to the normal float range
+ * [-126, 128).
+ */
+[[nodiscard]] inline float fastExp2(float x) {
+    x = std::clamp(x, -126.f, 127.99999f);
+    const auto whole = std::floor(x);
+    const auto f = x - whole;
+
+    auto p = detail::kExp2Poly[4];
+    for (int i = 3; i >= 0; --i)
+        p = p * f + detail::kExp2Poly[i];
+    return std::bit_cast<float>(std::bit_cast<int32_t>(p) + (static_cast<int32_t>(whole) << 23));
+}
+
+[[nodiscard]] inline float fastExp(float x) { return fastExp2(x * std::numbers::log2e_v<float>); }
+
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Mel-frequency cepstral coefficients from log-mel energies (the output of applyMelFilterbank()),
+ * with optional deltas and delta-deltas.
+ *
+ * The orthonormal DCT-II basis, with the sinusoidal lifter folded in, is built once in the
+ * constructor, so each coefficient is one vectorised dot product over the mel frame.
+ *
+ * Deltas use the usual regression over ±deltaWidth frames,
+ * d[t] = Σ n · (c[t + n] - c[t - n]) / (2 Σ n²), computed incrementally from a ring of recent
+ * frames. Because they look ahead, process() outputs every frame getLatencyInFrames() frames
+ * late; the first frame is repeated to pad the start of the stream, and flush() repeats the last
+ * one to output the remaining frames once the stream ends. Nothing is allocated after
+ * construction.
+ */
+class Mfcc {
+  public:
+    /**
+     * @param numMelBins Length of the log-mel frames passed to process()
+     * @param numCoefficients Number of cepstral coefficients (c0 included, <= numMelBins)
+     * @param lifter Lifter parameter L (c[n] *= 1 + L / 2 · sin(π n / L)); 0 disables liftering
+     * @param deltaWidth Frames either side used for deltas; 0 disables deltas (and the latency)
+     */
+    Mfcc(std::size_t numMelBins, std::size_t numCoefficients = 13, float lifter = 22.f, int deltaWidth = 2) :
+        mNumMelBins(numMelBins),
+        mNumCoefficients(numCoefficients),
+        mDeltaWidth(deltaWidth),
+        mBasis(numCoefficients * numMelBins),
+        mRingSize(2 * static_cast<std::size_t>(std::max(deltaWidth, 0)) + 1),
+        mCepstra(mRingSize * numCoefficients),
+        mDeltas(deltaWidth > 0 ? mRingSize * numCoefficients : 0),
+        mDeltaDelta(deltaWidth > 0 ? numCoefficients : 0) {
+        tb_throwIf(numMelBins == 0);
+        tb_throwIf(numCoefficients == 0 || numCoefficients > numMelBins);
+        tb_throwIf(lifter < 0.f);
+        tb_throwIf(deltaWidth < 0);
+
+        const auto m = static_cast<double>(numMelBins);
+        for (std::size_t n = 0; n < numCoefficients; ++n) {
+            const auto scale = std::sqrt((n == 0 ? 1.0 : 2.0) / m);
+            const auto lift = lifter > 0.f ? 1.0 + lifter / 2.0 * std::sin(std::numbers::pi * n / lifter) : 1.0;
+            for (std::size_t k = 0; k < numMelBins; ++k)
+                mBasis[n * numMelBins + k] = static_cast<float>(
+                    lift * scale * std::cos(std::numbers::pi * n * (k + 0.5) / m));
+        }
+
+        for (int i = 1; i <= deltaWidth; ++i)
+            mDeltaNorm += 2.0f * static_cast<float>(i * i);
+    }
+
+    /**
+     * Computes the (liftered) cepstrum of one log-mel frame, without touching the delta state
+     *
+     * @param logMel getNumMelBins() log-mel energies
+     * @param dst getNumCoefficients() outputs
+     */
+    void computeCoefficients(std::span<const float> logMel, std::span<float> dst) const {
+        tb_assert(logMel.size() == mNumMelBins && dst.size() == mNumCoefficients);
+        for (std::size_t n = 0; n < mNumCoefficients; ++n)
+            dst[n] = static_cast<float>(simd::dot({ mBasis.data() + n * mNumMelBins, mNumMelBins }, logMel));
+    }
+
+    /**
+     * Feeds the next log-mel frame
+     *
+     * @return True if a frame is ready: getCoefficients(), getDelta() and getDeltaDelta() then
+     *         describe the frame getLatencyInFrames() before this one, until the next call
+     */
+    bool process(std::span<const float> logMel) {
+        const auto t = static_cast<long long>(mNumFrames++);
+        ++mNumInputFrames;
+        computeCoefficients(logMel, cepstrum(t));
+        return advance(t);
+    }
+
+    /**
+     * Outputs the next of the frames still held back at the end of the stream, padding it by
+     * repeating the last cepstrum (and, for the delta-deltas, the last delta). Call until it
+     * returns false, then reset() before starting a new stream.
+     *
+     * @return True if a frame is ready, as for process()
+     */
+    bool flush() {
+        const auto numInputFrames = static_cast<long long>(mNumInputFrames);
+        if (mDeltaWidth == 0 || numInputFrames == 0)
+            return false;
+
+        for (;;) {
+            const auto t = static_cast<long long>(mNumFrames);
+            if (t - getLatencyInFrames() >= numInputFrames)
+                return false;
+
+            ++mNumFrames;
+            std::copy_n(cepstrum(numInputFrames - 1).begin(), mNumCoefficients, cepstrum(t).begin());
+            if (advance(t))
+                return true;
+        }
+    }
+
+    std::span<const float> getCoefficients() const {
+        return { mCepstra.data() + slotOffset(mOutputFrame), mNumCoefficients };
+    }
+
+    /**
+     * @return The deltas of the output frame (empty if deltaWidth is 0)
+     */
+    std::span<const float> getDelta() const {
+        if (mDeltaWidth == 0)
+            return {};
+        return { mDeltas.data() + slotOffset(mOutputFrame), mNumCoefficients };
+    }
+
+    /**
+     * @return The delta-deltas of the output frame (empty if deltaWidth is 0)
+     */
+    std::span<const float> getDeltaDelta() const { return mDeltaDelta; }
+
+    /**
+     * @return How many frames after its input process() outputs a frame (2 · deltaWidth)
+     */
+    int getLatencyInFrames() const noexcept { return 2 * mDeltaWidth; }
+
+    std::size_t getNumMelBins() const noexcept { return mNumMelBins; }
+    std::size_t getNumCoefficients() const noexcept { return mNumCoefficients; }
+
+    void reset() {
+        mNumFrames = 0;
+        mNumInputFrames = 0;
+        mOutputFrame = 0;
+        std::fill(mDeltaDelta.begin(), mDeltaDelta.end(), 0.f);
+    }
+
+  private:
+    // Updates the deltas once cepstrum(t) is in place; true if a frame is ready for output
+    bool advance(long long t) {
+        if (mDeltaWidth == 0) {
+            mOutputFrame = t;
+            return true;
+        }
+
+        const auto width = static_cast<long long>(mDeltaWidth);
+        if (t == 0) {
+            for (long long f = -2 * width; f < 0; ++f)
+                std::copy_n(cepstrum(0).begin(), mNumCoefficients, cepstrum(f).begin());
+        }
+
+        if (t < width)
+            return false;
+
+        // Delta of frame t - width from the cepstra of frames t - 2 · width .. t. Past the end of
+        // the input, flush() pads the deltas like the cepstra, by repeating the last one
+        const auto deltaFrame = t - width;
+        const auto lastInputFrame = static_cast<long long>(mNumInputFrames) - 1;
+        if (deltaFrame <= lastInputFrame)
+            regression([&](long long offset) { return cepstrum(deltaFrame + offset); }, delta(deltaFrame));
+        else
+            std::copy_n(delta(lastInputFrame).begin(), mNumCoefficients, delta(deltaFrame).begin());
+        if (deltaFrame == 0) {
+            for (long long f = -2 * width; f < 0; ++f)
+                std::copy_n(delta(0).begin(), mNumCoefficients, delta(f).begin());
+        }
+
+        if (deltaFrame < width)
+            return false;
+
+        // Delta-delta of frame t - 2 · width from the deltas of frames t - 3 · width .. t - width
+        mOutputFrame = deltaFrame - width;
+        regression([&](long long offset) { return delta(mOutputFrame + offset); }, mDeltaDelta);
+        return true;
+    }
+
+    // Start of a frame's slot in the rings (negative frames are the padding before the stream)
+    std::size_t slotOffset(long long frame) const {
+        const auto size = static_cast<long long>(mRingSize);
+        return static_cast<std::size_t>(((frame % size) + size) % size) * mNumCoefficients;
+    }
+
+    std::span<float> cepstrum(long long frame) { return { mCepstra.data() + slotOffset(frame), mNumCoefficients }; }
+    std::span<float> delta(long long frame) { return { mDeltas.data() + slotOffset(frame), mNumCoefficients }; }
+
+    template<typename FrameAt>
+    void regression(FrameAt frameAt, std::span<float> dst) {
+        std::fill(dst.begin(), dst.end(), 0.f);
+        for (int n = 1; n <= mDeltaWidth; ++n) {
+            const auto ahead = frameAt(n);
+            const auto behind = frameAt(-n);
+            for (std::size_t i = 0; i < mNumCoefficients; ++i)
+                dst[i] += static_cast<float>(n) * (ahead[i] - behind[i]);
+        }
+        for (auto& d : dst)
+            d /= mDeltaNorm;
+    }
+
+    std::size_t mNumMelBins = 0;
+    std::size_t mNumCoefficients = 0;
+    int mDeltaWidth = 0;
+    float mDeltaNorm = 0.f;
+    std::vector<float> mBasis;  // numCoefficients rows of numMelBins, lifter applied
+
+    std::size_t mRingSize = 1;
+    std::vector<float> mCepstra;     // Ring of the last 2 · deltaWidth + 1 cepstra
+    std::vector<float> mDeltas;      // Ring of the last 2 · deltaWidth + 1 deltas
+    std::vector<float> mDeltaDelta;  // Delta-delta of the output frame
+    unsigned long long mNumFrames = 0;       // Fed so far, including flush() padding
+    unsigned long long mNumInputFrames = 0;  // Passed to process()
+    long long mOutputFrame = 0;
+};
+
+}
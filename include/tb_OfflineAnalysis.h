@@ -0,0 +1,147 @@
+#pragma once
+
+#include "tb_AudioFeatures.h"
+#include "tb_Core.h"
+#include "tb_OnsetDetection.h"
+#include "tb_Stft.h"
+#include "tb_ThreadPool.h"
+#include "tb_Windowing.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <vector>
+
+namespace tb {
+
+struct OfflineAnalysisSettings {
+    double sampleRate = 48000.0;
+    int frameSize = 2048;
+    int hopSize = 512;
+    WindowType windowType = WindowType::Hann;
+
+    std::size_t numMelBins = 64;
+    double melMinHz = 20.0;
+    double melMaxHz = -1.0;  // -1 → nyquist
+    FrequencyScale melScale = FrequencyScale::MelHtk;
+    FilterbankNorm melNorm = FilterbankNorm::None;
+
+    int framesPerChunk = 256;  // Unit of work handed to each thread
+};
+
+/**
+ * Frame-by-frame features of one channel. Frame f starts at sample f * hopSize.
+ */
+struct OfflineFeatures {
+    std::size_t numFrames = 0;
+    std::size_t numMelBins = 0;
+    std::vector<float> mel;       // numFrames × numMelBins, log energies (applyMelFilterbank)
+    std::vector<float> flux;      // spectralFlux of the magnitude spectrum (0 for frame 0)
+    std::vector<float> rms;       // rmsEnergy of the un-windowed frame
+    std::vector<float> centroid;  // spectralCentroid of the power spectrum, in Hz
+};
+
+/**
+ * @return The number of complete frames analyseOffline() finds in numSamples samples
+ */
+inline std::size_t numOfflineFrames(std::size_t numSamples, int frameSize, int hopSize) {
+    if (numSamples < static_cast<std::size_t>(frameSize))
+        return 0;
+    return (numSamples - frameSize) / hopSize + 1;
+}
+
+/**
+ * Extracts mel, flux, RMS and centroid series from a whole buffer, optionally across threads.
+ *
+ * The frames are split into chunks of `framesPerChunk`. Each chunk runs its own Stft over just
+ * the samples its frames cover, plus the frame before it so the flux of its first frame sees
+ * the right previous spectrum. Every frame therefore goes through exactly the same arithmetic
+ * as in a single sequential pass, so the output is bit-identical whatever the chunk size or
+ * thread count.
+ *
+ * @param input Planar audio; every channel gets its own OfflineFeatures
+ * @param settings Framing and filterbank parameters
+ * @param threadPool Pool to spread the chunks over, or nullptr to run on the calling thread
+ * @return One OfflineFeatures per input channel
+ */
+inline std::vector<OfflineFeatures> analyseOffline(choc::buffer::ChannelArrayView<float> input,
+                                                   const OfflineAnalysisSettings& settings,
+                                                   ThreadPool* threadPool = nullptr) {
+    tb_throwIf(settings.framesPerChunk <= 0);
+    tb_throwIf(settings.hopSize <= 0 || settings.hopSize > settings.frameSize);
+
+    const auto numChannels = static_cast<int>(input.getNumChannels());
+    const auto numFrames = numOfflineFrames(input.getNumFrames(), settings.frameSize, settings.hopSize);
+    const auto numBins = static_cast<std::size_t>(settings.frameSize / 2 + 1);
+    const auto numMelBins = settings.numMelBins;
+    const auto& filterbank = cachedMelFilterbank({ .nMelBins = numMelBins,
+                                                   .nFftBins = numBins,
+                                                   .sampleRate = settings.sampleRate,
+                                                   .fMin = settings.melMinHz,
+                                                   .fMax = settings.melMaxHz,
+                                                   .scale = settings.melScale,
+                                                   .norm = settings.melNorm });
+
+    std::vector<OfflineFeatures> features(numChannels);
+    for (auto& f : features) {
+        f.numFrames = numFrames;
+        f.numMelBins = numMelBins;
+        f.mel.resize(numFrames * numMelBins);
+        f.flux.resize(numFrames);
+        f.rms.resize(numFrames);
+        f.centroid.resize(numFrames);
+    }
+
+    if (numFrames == 0 || numChannels == 0)
+        return features;
+
+    const auto chunkSize = static_cast<std::size_t>(settings.framesPerChunk);
+    const auto numChunks = static_cast<int>((numFrames + chunkSize - 1) / chunkSize);
+
+    auto analyseChunk = [&](int chunk) {
+        const auto firstFrame = chunk * chunkSize;
+        const auto endFrame = std::min(numFrames, firstFrame + chunkSize);
+
+        // Start one frame early (when there is one) to get the previous magnitude spectrum
+        const auto warmUpFrame = firstFrame > 0 ? firstFrame - 1 : firstFrame;
+        const auto startSample = warmUpFrame * settings.hopSize;
+        const auto endSample = (endFrame - 1) * settings.hopSize + settings.frameSize;
+
+        // The flux trackers take the only magnitude pass, written straight into their frames
+        Stft stft(numChannels, settings.frameSize, settings.hopSize, settings.windowType, WindowSymmetry::Symmetric,
+                  Stft::Spectra::PowerOnly);
+        std::vector<SpectralFluxTracker> fluxTrackers(numChannels, SpectralFluxTracker(numBins));
+
+        auto frame = warmUpFrame;
+        stft.process(input.getFrameRange({ static_cast<uint32_t>(startSample),
+                                           static_cast<uint32_t>(endSample) }),
+                     [&](const Stft& s) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto& tracker = fluxTrackers[ch];
+                s.getMagnitudeSpectrum(ch, tracker.getNextFrame());
+                const auto flux = tracker.processNextFrame();
+                if (frame >= firstFrame) {
+                    auto& out = features[ch];
+                    const auto power = s.getPowerSpectrum(ch);
+                    applyMelFilterbank(power, filterbank,
+                                       std::span(out.mel).subspan(frame * numMelBins, numMelBins));
+                    out.flux[frame] = flux;
+                    out.rms[frame] = rmsEnergy(s.getFrame(ch));
+                    out.centroid[frame] = spectralCentroid(power, settings.sampleRate);
+                }
+            }
+            ++frame;
+        });
+
+        tb_assert(frame == endFrame);
+    };
+
+    if (threadPool != nullptr)
+        threadPool->parallelFor(numChunks, analyseChunk);
+    else
+        for (int chunk = 0; chunk < numChunks; ++chunk)
+            analyseChunk(chunk);
+
+    return features;
+}
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "tb_AudioFeatures.h"
+#include "tb_Core.h"
+#include "tb_Instrumentation.h"
+#include "tb_Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Stateful spectral flux: the positive difference between consecutive frames, with the previous
+ * frame kept internally.
+ *
+ * Frames live in two internal buffers that swap roles after every frame, so nothing is allocated
+ * after construction. process() takes a spectrum from anywhere and copies it in (log
+ * compression and band reduction write their result instead, so they cost no extra copy). To
+ * skip that copy in the plain per-bin mode, write the magnitudes straight into getNextFrame(),
+ * e.g. with Stft::getMagnitudeSpectrum(channel, dst) on an Stft built with Stft::Spectra::PowerOnly
+ * (which then computes them there and nowhere else), and call processNextFrame().
+ *
+ * Log compression maps every value x to log(1 + gamma · x) before differencing, which makes the
+ * flux follow relative rather than absolute level changes. In band mode the magnitude spectrum
+ * is first reduced to mel band energies, and the flux of each band is available separately.
+ */
+class SpectralFluxTracker {
+  public:
+    /**
+     * Per-bin flux
+     *
+     * @param numBins Length of the magnitude spectra passed to process()
+     * @param logGamma Log compression factor gamma (0 disables compression)
+     */
+    explicit SpectralFluxTracker(std::size_t numBins, float logGamma = 0.f) :
+        mNumBins(numBins),
+        mLogGamma(logGamma),
+        mCurrent(numBins),
+        mPrevious(numBins) {
+        tb_throwIf(numBins == 0);
+        tb_throwIf(logGamma < 0.f);
+    }
+
+    /**
+     * Per-band flux over a mel filterbank
+     *
+     * @param filterbank Filterbank the magnitude spectra are reduced with (copied)
+     * @param logGamma Log compression factor gamma applied to the band energies (0 disables)
+     */
+    explicit SpectralFluxTracker(SparseMelFilterbank filterbank, float logGamma = 0.f) :
+        mNumBins(filterbank.numFftBins),
+        mLogGamma(logGamma),
+        mFilterbank(std::move(filterbank)),
+        mCurrent(mFilterbank.numMelBins()),
+        mPrevious(mFilterbank.numMelBins()),
+        mBandFlux(mFilterbank.numMelBins()) {
+        tb_throwIf(mNumBins == 0 || mFilterbank.numMelBins() == 0);
+        tb_throwIf(logGamma < 0.f);
+    }
+
+    /**
+     * Feeds the next magnitude spectrum
+     *
+     * @return The flux against the previous frame (0 for the first frame after construction or
+     *         reset())
+     */
+    float process(std::span<const float> magnitude) {
+        tb_instrumentStage(SpectralFlux);
+        tb_assert(magnitude.size() == mNumBins);
+
+        if (isBanded()) {
+            double flux = 0.0;
+            for (std::size_t m = 0; m < mCurrent.size(); ++m) {
+                const auto& band = mFilterbank.bands[m];
+                const auto energy = simd::dot(mFilterbank.bandWeights(m), magnitude.subspan(band.startBin, band.length));
+                mCurrent[m] = compress(static_cast<float>(energy));
+                mBandFlux[m] = mHasPrevious ? std::max(mCurrent[m] - mPrevious[m], 0.f) : 0.f;
+                flux += mBandFlux[m];
+            }
+            return finishFrame(flux);
+        }
+
+        if (mLogGamma > 0.f)
+            return finishFrame(compressAndDiff(magnitude.data()));
+
+        std::copy(magnitude.begin(), magnitude.end(), mCurrent.begin());
+        return finishFrame(mHasPrevious ? simd::positiveDifferenceSum(mPrevious, mCurrent) : 0.0);
+    }
+
+    /**
+     * Storage for the next magnitude spectrum, getNumBins() long (per-bin mode only). Fill it and
+     * call processNextFrame() instead of passing the spectrum to process()
+     */
+    std::span<float> getNextFrame() noexcept {
+        tb_assert(! isBanded());
+        return mCurrent;
+    }
+
+    /**
+     * Same as process(), for the magnitude spectrum written into getNextFrame(). Log compression
+     * is applied in place, in the same pass as the difference
+     */
+    float processNextFrame() {
+        tb_instrumentStage(SpectralFlux);
+        tb_assert(! isBanded());
+
+        if (mLogGamma > 0.f)
+            return finishFrame(compressAndDiff(mCurrent.data()));
+        return finishFrame(mHasPrevious ? simd::positiveDifferenceSum(mPrevious, mCurrent) : 0.0);
+    }
+
+    /**
+     * @return The flux of every mel band for the last frame (band mode only; empty otherwise)
+     */
+    std::span<const float> getBandFlux() const noexcept { return mBandFlux; }
+
+    /**
+     * @return The last frame as it was compared: compressed bins or band energies
+     */
+    std::span<const float> getLastFrame() const noexcept { return mPrevious; }
+
+    bool isBanded() const noexcept { return ! mBandFlux.empty(); }
+
+    /**
+     * Forgets the previous frame; the next process() returns 0
+     */
+    void reset() {
+        mHasPrevious = false;
+        std::fill(mBandFlux.begin(), mBandFlux.end(), 0.f);
+    }
+
+    std::size_t getNumBins() const noexcept { return mNumBins; }
+
+  private:
+    float compress(float x) const { return mLogGamma > 0.f ? std::log1p(mLogGamma * x) : x; }
+
+    // Compresses src into the current frame and sums its positive difference to the previous one
+    // in a single pass. src may be the current frame itself
+    double compressAndDiff(const float* src) {
+        if (! mHasPrevious) {
+            for (std::size_t k = 0; k < mNumBins; ++k)
+                mCurrent[k] = std::log1p(mLogGamma * src[k]);
+            return 0.0;
+        }
+
+        double flux = 0.0;
+        for (std::size_t k = 0; k < mNumBins; ++k) {
+            mCurrent[k] = std::log1p(mLogGamma * src[k]);
+            flux += std::max(mCurrent[k] - mPrevious[k], 0.f);
+        }
+        return flux;
+    }
+
+    float finishFrame(double flux) {
+        std::swap(mCurrent, mPrevious);
+        mHasPrevious = true;
+        return static_cast<float>(flux);
+    }
+
+    std::size_t mNumBins = 0;
+    float mLogGamma = 0.f;
+    SparseMelFilterbank mFilterbank;
+    std::vector<float> mCurrent;
+    std::vector<float> mPrevious;
+    std::vector<float> mBandFlux;
+    bool mHasPrevious = false;
+};
+
+struct PeakPickerSettings {
+    int preMax = 3;
+    int postMax = 1;
+    int preAvg = 10;
+    int postAvg = 1;
+    float delta = 0.05f;  // In units of the detection function
+    int minInterval = 3;  // Minimum frames between onsets
+};
+
+/**
+ * Streaming onset picker for an onset detection function, such as the output of
+ * SpectralFluxTracker.
+ *
+ * Frame n is an onset when it is the maximum of [n - preMax, n + postMax], exceeds the mean of
+ * [n - preAvg, n + postAvg] by at least delta, and comes more than minInterval frames after the
+ * previous onset. Looking ahead means every decision is made getLatencyInFrames() frames late.
+ */
+class AdaptivePeakPicker {
+  public:
+    explicit AdaptivePeakPicker(PeakPickerSettings settings = {}) :
+        mSettings(settings),
+        mLatency(std::max(settings.postMax, settings.postAvg)),
+        mHistory(static_cast<std::size_t>(std::max(settings.preMax, settings.preAvg) + mLatency + 1)) {
+        tb_throwIf(settings.preMax < 0 || settings.postMax < 0 || settings.preAvg < 0 || settings.postAvg < 0);
+        tb_throwIf(settings.minInterval < 0);
+        reset();
+    }
+
+    /**
+     * Feeds the detection function value of the next frame
+     *
+     * @return True if the frame getLatencyInFrames() before this one is an onset
+     */
+    bool process(float value) {
+        const auto newest = mNumFrames++;
+        at(newest) = value;
+
+        if (newest < mLatency)
+            return false;
+
+        const auto candidate = newest - mLatency;
+        const auto centre = at(candidate);
+
+        const auto maxFrom = std::max<int64_t>(0, candidate - mSettings.preMax);
+        for (auto n = maxFrom; n <= candidate + mSettings.postMax; ++n)
+            if (at(n) > centre)
+                return false;
+
+        const auto avgFrom = std::max<int64_t>(0, candidate - mSettings.preAvg);
+        const auto avgTo = candidate + mSettings.postAvg;
+        float sum = 0.f;
+        for (auto n = avgFrom; n <= avgTo; ++n)
+            sum += at(n);
+        if (centre < sum / static_cast<float>(avgTo - avgFrom + 1) + mSettings.delta)
+            return false;
+
+        if (mLastOnset >= 0 && candidate - mLastOnset <= mSettings.minInterval)
+            return false;
+
+        mLastOnset = candidate;
+        return true;
+    }
+
+    /**
+     * @return How many frames after an onset process() reports it
+     */
+    int getLatencyInFrames() const noexcept { return static_cast<int>(mLatency); }
+
+    /**
+     * @return The frame index (counting from the first process() call) of the last onset, or -1
+     */
+    int64_t getLastOnsetFrame() const noexcept { return mLastOnset; }
+
+    void reset() {
+        std::fill(mHistory.begin(), mHistory.end(), 0.f);
+        mNumFrames = 0;
+        mLastOnset = -1;
+    }
+
+  private:
+    float& at(int64_t frame) { return mHistory[static_cast<std::size_t>(frame) % mHistory.size()]; }
+
+    PeakPickerSettings mSettings;
+    int64_t mLatency = 0;
+    std::vector<float> mHistory;  // Ring buffer of the last preX + latency + 1 values
+    int64_t mNumFrames = 0;
+    int64_t mLastOnset = -1;
+};
+
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Simd.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <numeric>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Fixed-ratio polyphase FIR resampler with no external dependencies.
+ *
+ * Works with non-interleaved (planar) audio data, like SampleRateConverter, but the ratio is
+ * fixed at construction: both sample rates must be whole numbers of Hz, and their reduced
+ * ratio L/M (e.g. 160/147 for 44.1k → 48k) selects one of L precomputed filter phases per
+ * output sample. Each output is then a single vectorised dot product, instead of the
+ * per-sample sinc interpolation a variable-ratio converter has to do.
+ *
+ * The filter is a Kaiser-windowed sinc designed per quality tier from the same targets as the
+ * libsamplerate presets (stopband attenuation / passband width relative to the lower of the
+ * two Nyquist frequencies). Processing runs in float, which limits the achievable noise floor
+ * of BestQuality to roughly that of float arithmetic.
+ */
+class PolyphaseResampler {
+public:
+    /**
+     * Quality tiers, named after the matching SampleRateConverter presets
+     */
+    enum class Quality {
+        BestQuality,    // 144 dB stopband, 96% passband
+        MediumQuality,  // 121 dB stopband, 90% passband
+        Fastest         // 97 dB stopband, 80% passband
+    };
+
+    /**
+     * @param numChannels Number of audio channels (must be > 0)
+     * @param inSampleRate Input sample rate in Hz (whole number)
+     * @param outSampleRate Output sample rate in Hz (whole number)
+     * @param quality Filter quality
+     */
+    PolyphaseResampler(int numChannels, double inSampleRate, double outSampleRate, Quality quality) {
+        tb_throwIf(numChannels <= 0);
+        tb_throwIf(inSampleRate <= 0.0 || outSampleRate <= 0.0);
+        tb_throwMsgIf(inSampleRate != std::round(inSampleRate) || outSampleRate != std::round(outSampleRate),
+                      "PolyphaseResampler needs whole-number sample rates");
+
+        const auto inRate = static_cast<long long>(inSampleRate);
+        const auto outRate = static_cast<long long>(outSampleRate);
+        const auto divisor = std::gcd(inRate, outRate);
+        mUp = static_cast<int>(outRate / divisor);
+        mDown = static_cast<int>(inRate / divisor);
+        tb_throwMsgIf(mUp > kMaxFactor || mDown > kMaxFactor,
+                      "PolyphaseResampler ratio is not a simple enough fraction");
+
+        designFilter(quality, inSampleRate, outSampleRate);
+
+        mLines = choc::buffer::ChannelArrayBuffer<float>(numChannels, mTapsPerPhase - 1 + kChunkSize + mDown / mUp + 1);
+        reset();
+    }
+
+    // Prevent copying & moving
+    PolyphaseResampler(const PolyphaseResampler&) = delete;
+    PolyphaseResampler& operator=(const PolyphaseResampler&) = delete;
+
+    struct Result {
+        choc::buffer::ChannelArrayView<float> remainingInput;
+        choc::buffer::ChannelArrayView<float> actualOutput;
+    };
+
+    /**
+     * Process audio using choc::buffer::ChannelArrayView (non-interleaved/planar)
+     * @param input Input buffer view
+     * @param output Output buffer view (must be pre-allocated)
+     * @param endOfInput True if this is the last buffer. The filter tail is then flushed with
+     *                   silence; call reset() before processing a new stream
+     * @return The unconsumed part of the input and the part of the output that was written
+     */
+    Result process(choc::buffer::ChannelArrayView<float> input, choc::buffer::ChannelArrayView<float> output,
+                   bool endOfInput = false) {
+        tb_assert(input.getNumChannels() == mLines.getNumChannels() &&
+                  output.getNumChannels() == mLines.getNumChannels());
+
+        const auto inFrames = static_cast<int>(input.getNumFrames());
+        const auto outFrames = static_cast<int>(output.getNumFrames());
+
+        if (mUp == mDown) {
+            const auto framesToCopy = std::min(inFrames, outFrames);
+            choc::buffer::copy(output.getStart(framesToCopy), input.getStart(framesToCopy));
+            return { .remainingInput = input.fromFrame(framesToCopy),
+                     .actualOutput = output.getStart(framesToCopy) };
+        }
+
+        const auto numChannels = getNumChannels();
+        const auto taps = static_cast<size_t>(mTapsPerPhase);
+        const auto capacity = static_cast<int>(mLines.getNumFrames());
+
+        int inUsed = 0;
+        int outGenerated = 0;
+        for (;;) {
+            // Produce every output whose newest input sample is already in the line
+            while (outGenerated < outFrames && mNext < mLineFill) {
+                const std::span<const float> phase(mPhases.data() + mPhase * taps, taps);
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    const auto* history = mLines.getChannel(ch).data.data + (mNext - mTapsPerPhase + 1);
+                    output.getSample(ch, outGenerated) = static_cast<float>(simd::dot(phase, { history, taps }));
+                }
+
+                ++outGenerated;
+                mPhase += mDown;
+                mNext += mPhase / mUp;
+                mPhase %= mUp;
+            }
+
+            if (outGenerated == outFrames)
+                break;
+
+            // Drop samples that no future output reaches back to
+            const auto drop = std::min(mNext - (mTapsPerPhase - 1), mLineFill);
+            if (drop > 0) {
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    auto* line = mLines.getChannel(ch).data.data;
+                    std::memmove(line, line + drop, static_cast<size_t>(mLineFill - drop) * sizeof(float));
+                }
+                mNext -= drop;
+                mLineFill -= drop;
+            }
+
+            // Refill from the input, then from silence once the input has ended
+            const auto space = capacity - mLineFill;
+            const auto fromInput = std::min(space, inFrames - inUsed);
+            if (fromInput > 0) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    std::memcpy(mLines.getChannel(ch).data.data + mLineFill,
+                                input.getChannel(ch).data.data + inUsed,
+                                static_cast<size_t>(fromInput) * sizeof(float));
+                inUsed += fromInput;
+                mLineFill += fromInput;
+            } else if (endOfInput && inUsed == inFrames && mFlushRemaining > 0) {
+                const auto silence = std::min(space, mFlushRemaining);
+                for (int ch = 0; ch < numChannels; ++ch)
+                    std::fill_n(mLines.getChannel(ch).data.data + mLineFill, silence, 0.f);
+                mFlushRemaining -= silence;
+                mLineFill += silence;
+            } else {
+                break;
+            }
+        }
+
+        return { .remainingInput = input.fromFrame(inUsed),
+                 .actualOutput = output.getStart(outGenerated) };
+    }
+
+    /**
+     * Reset the filter history for all channels
+     */
+    void reset() {
+        mLines.clear();
+        mLineFill = mTapsPerPhase - 1;  // Zero history before the first input sample
+        mNext = mLineFill;
+        mPhase = 0;
+        mFlushRemaining = getLatencyInSamples() + 1;
+    }
+
+    /**
+     * @return The number of channels set in the constructor
+     */
+    int getNumChannels() const noexcept { return static_cast<int>(mLines.getNumChannels()); }
+
+    /**
+     * @return The filter's group delay, in input samples
+     */
+    int getLatencyInSamples() const noexcept {
+        if (mUp == mDown)
+            return 0;
+        return static_cast<int>(std::lround((static_cast<double>(mTapsPerPhase) * mUp - 1.0) / (2.0 * mUp)));
+    }
+
+    /**
+     * @return L in the reduced conversion ratio L/M
+     */
+    int getUpFactor() const noexcept { return mUp; }
+
+    /**
+     * @return M in the reduced conversion ratio L/M
+     */
+    int getDownFactor() const noexcept { return mDown; }
+
+    /**
+     * @return The length of each filter phase (the dot product size per output sample)
+     */
+    int getTapsPerPhase() const noexcept { return mTapsPerPhase; }
+
+private:
+    static constexpr int kMaxFactor = 4096;
+    static constexpr int kChunkSize = 1024;
+
+    static double besselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 64 && term > sum * 1e-16; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    void designFilter(Quality quality, double inSampleRate, double outSampleRate) {
+        if (mUp == mDown) {
+            mTapsPerPhase = 1;
+            return;
+        }
+
+        double attenuation = 0.0;
+        double passband = 0.0;
+        switch (quality) {
+        case Quality::BestQuality: attenuation = 144.0; passband = 0.96; break;
+        case Quality::MediumQuality: attenuation = 121.0; passband = 0.90; break;
+        case Quality::Fastest: attenuation = 97.0; passband = 0.80; break;
+        }
+
+        // Everything below is relative to the lower of the two rates
+        const auto lowRate = std::min(inSampleRate, outSampleRate);
+        const auto transition = (1.0 - passband) * 0.5;  // Passband edge → Nyquist, in cycles/sample
+        const auto tapsAtLowRate = (attenuation - 7.95) / (14.36 * transition);
+        mTapsPerPhase = std::max(2, static_cast<int>(std::ceil(tapsAtLowRate * inSampleRate / lowRate)));
+
+        // Prototype low-pass at the upsampled rate, cutoff in the middle of the transition band
+        const auto numTaps = mTapsPerPhase * mUp;
+        const auto cutoff = (passband + 1.0) * 0.25 * lowRate / (inSampleRate * mUp);
+        const auto beta = 0.1102 * (attenuation - 8.7);
+        const auto center = (numTaps - 1) / 2.0;
+
+        std::vector<double> prototype(numTaps);
+        double sum = 0.0;
+        for (int n = 0; n < numTaps; ++n) {
+            const auto x = n - center;
+            const auto arg = 2.0 * std::numbers::pi * cutoff * x;
+            const auto sinc = x == 0.0 ? 1.0 : std::sin(arg) / arg;
+            const auto r = x / center;
+            const auto window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+            prototype[n] = sinc * window;
+            sum += prototype[n];
+        }
+
+        // Phase p holds taps p, p + L, p + 2L, ... reversed, so that each output is a forward dot
+        // product with the oldest-to-newest history
+        const auto gain = mUp / sum;
+        mPhases.resize(static_cast<size_t>(numTaps));
+        for (int p = 0; p < mUp; ++p)
+            for (int j = 0; j < mTapsPerPhase; ++j)
+                mPhases[p * mTapsPerPhase + (mTapsPerPhase - 1 - j)] = static_cast<float>(prototype[p + j * mUp] * gain);
+    }
+
+    int mUp = 1;
+    int mDown = 1;
+    int mTapsPerPhase = 1;
+    std::vector<float> mPhases;  // mUp phases of mTapsPerPhase taps each
+
+    choc::buffer::ChannelArrayBuffer<float> mLines;  // Per-channel history + pending input
+    int mLineFill = 0;        // Valid samples in each line
+    int mNext = 0;            // Line index of the newest sample the next output uses
+    int mPhase = 0;           // Filter phase of the next output
+    int mFlushRemaining = 0;  // Silence still to feed after end of input
+};
+
+}
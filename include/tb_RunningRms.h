@@ -0,0 +1,140 @@
+#pragma once
+
+#include "tb_Core.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Streaming multichannel RMS with an O(1) update per sample, for metering.
+ *
+ * In Window mode it is a true sliding window: each channel keeps the squares of its last
+ * windowSize samples in a ring and a running sum in double, which is recomputed from the ring
+ * every time the ring wraps so rounding errors cannot build up (amortised O(1)). Until
+ * windowSize samples have been seen, the missing ones count as silence.
+ *
+ * In Exponential mode it is a one-pole (ballistic) mean-square follower whose time constant is
+ * windowSize samples.
+ *
+ * All storage is allocated in the constructor, so processing is safe on the audio thread.
+ */
+class RunningRms {
+  public:
+    enum class Mode {
+        Window,      // Rectangular sliding window of windowSize samples
+        Exponential  // One-pole smoothing with a time constant of windowSize samples
+    };
+
+    /**
+     * @param numChannels Number of audio channels (must be > 0)
+     * @param windowSize Window length or time constant in samples (must be > 0)
+     * @param mode Sliding window or exponential averaging
+     */
+    RunningRms(int numChannels, int windowSize, Mode mode = Mode::Window) :
+        mMode(mode),
+        mWindowSize(windowSize) {
+        tb_throwIf(numChannels <= 0);
+        tb_throwIf(windowSize <= 0);
+
+        mCoefficient = 1.0 - std::exp(-1.0 / windowSize);
+        mAccumulators.resize(static_cast<std::size_t>(numChannels));
+
+        if (mode == Mode::Window)
+            mSquares = choc::buffer::ChannelArrayBuffer<float>(numChannels, windowSize);
+
+        reset();
+    }
+
+    /**
+     * Pushes a block of audio
+     */
+    void process(choc::buffer::ChannelArrayView<float> input) { processBlock(input, nullptr); }
+
+    /**
+     * Pushes a block of audio and writes the RMS after every sample into output, which must be
+     * the same size as input (and may be input itself)
+     */
+    void process(choc::buffer::ChannelArrayView<float> input, choc::buffer::ChannelArrayView<float> output) {
+        tb_assert(output.getNumChannels() == input.getNumChannels() &&
+                  output.getNumFrames() == input.getNumFrames());
+        processBlock(input, &output);
+    }
+
+    /**
+     * @return The current RMS of a channel
+     */
+    float getRms(int channel) const { return static_cast<float>(std::sqrt(getMeanSquare(channel))); }
+
+    /**
+     * @return The current mean of the squared samples (energy) of a channel
+     */
+    double getMeanSquare(int channel) const {
+        const auto value = mMode == Mode::Window ? mAccumulators[channel] / mWindowSize : mAccumulators[channel];
+        return std::max(value, 0.0);
+    }
+
+    int getNumChannels() const noexcept { return static_cast<int>(mAccumulators.size()); }
+    int getWindowSize() const noexcept { return mWindowSize; }
+    Mode getMode() const noexcept { return mMode; }
+
+    void reset() {
+        mSquares.clear();
+        std::fill(mAccumulators.begin(), mAccumulators.end(), 0.0);
+        mWritePos = 0;
+    }
+
+  private:
+    void processBlock(choc::buffer::ChannelArrayView<float> input, choc::buffer::ChannelArrayView<float>* output) {
+        tb_assert(static_cast<int>(input.getNumChannels()) == getNumChannels());
+
+        const auto numFrames = static_cast<int>(input.getNumFrames());
+        auto writePos = mWritePos;
+        for (int ch = 0; ch < getNumChannels(); ++ch) {
+            const auto* in = input.getChannel(ch).data.data;
+            auto* out = output != nullptr ? output->getChannel(ch).data.data : nullptr;
+            auto& state = mAccumulators[ch];
+
+            if (mMode == Mode::Exponential) {
+                for (int i = 0; i < numFrames; ++i) {
+                    state += mCoefficient * (static_cast<double>(in[i]) * in[i] - state);
+                    if (out != nullptr)
+                        out[i] = static_cast<float>(std::sqrt(state));
+                }
+                continue;
+            }
+
+            auto* squares = mSquares.getChannel(ch).data.data;
+            writePos = mWritePos;
+            for (int i = 0; i < numFrames; ++i) {
+                const auto square = in[i] * in[i];
+                state += static_cast<double>(square) - squares[writePos];
+                squares[writePos] = square;
+
+                if (++writePos == mWindowSize) {
+                    writePos = 0;
+                    state = std::accumulate(squares, squares + mWindowSize, 0.0);
+                }
+
+                if (out != nullptr)
+                    out[i] = static_cast<float>(std::sqrt(std::max(state, 0.0) / mWindowSize));
+            }
+        }
+
+        if (mMode == Mode::Window)
+            mWritePos = writePos;
+    }
+
+    Mode mMode;
+    int mWindowSize = 0;
+    double mCoefficient = 0.0;
+    choc::buffer::ChannelArrayBuffer<float> mSquares;  // Window mode: ring of the last squares
+    std::vector<double> mAccumulators;                 // Running sum (Window) or mean square (Exponential)
+    int mWritePos = 0;
+};
+
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_FifoBuffer.h"
+#include "tb_Instrumentation.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace tb {
+
+/**
+ * Packed little-endian 24-bit sample, as found in WAV files and most audio interfaces
+ */
+struct Int24 {
+    uint8_t bytes[3] = {};
+};
+
+static_assert(sizeof(Int24) == 3);
+
+/**
+ * Sample types the conversion functions accept
+ */
+template<typename S>
+concept SampleType = std::same_as<S, int16_t> || std::same_as<S, Int24> || std::same_as<S, int32_t> ||
+                     std::same_as<S, float>;
+
+/**
+ * Triangular (TPDF) dither for conversion to integer samples: the difference of two uniform
+ * values, spanning ±1 LSB of the output format, which decorrelates the quantisation error from
+ * the signal. Uses a xorshift generator, so it is cheap, deterministic per seed and allocation
+ * free. Keep one per stream (or per channel), since next() changes its state.
+ */
+class TpdfDither {
+  public:
+    explicit TpdfDither(uint32_t seed = 0x9e3779b9u) : mState(seed != 0 ? seed : 1u) {}
+
+    /**
+     * @return The next dither value, in (-1, 1) LSB
+     */
+    float next() noexcept { return uniform() - uniform(); }
+
+  private:
+    float uniform() noexcept {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return static_cast<float>(mState >> 8) * (1.f / 16777216.f);
+    }
+
+    uint32_t mState;
+};
+
+namespace detail {
+
+// Scales to the integer range, adds dither, then rounds half away from zero by adding ±0.5 and
+// clipping before the truncating cast, which keeps +1.0 from wrapping to the most negative value.
+// The clip bounds are whole numbers, so clipping after the offset gives the same result as before
+// it, but keeps the loops calling this branch-free: GCC turns a clip followed by copysign() back
+// into control flow and gives up vectorising.
+inline int32_t quantise(float x, float scale, float dither) noexcept {
+    const auto v = x * scale + dither;
+    return static_cast<int32_t>(std::min(std::max(v + std::copysign(0.5f, v), -scale), scale - 1.f));
+}
+
+template<SampleType S>
+struct SampleTraits;
+
+template<>
+struct SampleTraits<int16_t> {
+    static float toFloat(int16_t s) noexcept { return static_cast<float>(s) * (1.f / 32768.f); }
+    static int16_t fromFloat(float x, float dither) noexcept {
+        return static_cast<int16_t>(quantise(x, 32768.f, dither));
+    }
+};
+
+template<>
+struct SampleTraits<Int24> {
+    static float toFloat(Int24 s) noexcept {
+        // Assemble in the top three bytes, then shift back down to sign-extend
+        const auto bits = (static_cast<uint32_t>(s.bytes[2]) << 24) | (static_cast<uint32_t>(s.bytes[1]) << 16) |
+                          (static_cast<uint32_t>(s.bytes[0]) << 8);
+        return static_cast<float>(static_cast<int32_t>(bits) >> 8) * (1.f / 8388608.f);
+    }
+    static Int24 fromFloat(float x, float dither) noexcept {
+        const auto v = static_cast<uint32_t>(quantise(x, 8388608.f, dither));
+        return { { static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v >> 16) } };
+    }
+};
+
+template<>
+struct SampleTraits<int32_t> {
+    static float toFloat(int32_t s) noexcept { return static_cast<float>(s) * (1.f / 2147483648.f); }
+    static int32_t fromFloat(float x, float dither) noexcept {
+        // float cannot represent the top of the int32 range, so scale in double
+        const auto v = static_cast<double>(x) * 2147483648.0 + dither;
+        return static_cast<int32_t>(std::min(std::max(v + std::copysign(0.5, v), -2147483648.0), 2147483647.0));
+    }
+};
+
+template<>
+struct SampleTraits<float> {
+    static float toFloat(float s) noexcept { return s; }
+    static float fromFloat(float x, float) noexcept { return x; }
+};
+
+template<SampleType S>
+constexpr bool kDitherable = ! std::same_as<S, float>;
+
+// Frames per block in the (de)interleave loops: the block's interleaved samples stay in L1 while
+// each channel is gathered from / scattered to them
+inline constexpr std::size_t kInterleaveBlock = 256;
+
+}
+
+/**
+ * Converts samples to float in [-1, 1). dst may not overlap src (unless S is float)
+ */
+template<SampleType S>
+void convert(std::span<const S> src, std::span<float> dst) {
+    tb_assert(src.size() == dst.size());
+    for (std::size_t i = 0; i < src.size(); ++i)
+        dst[i] = detail::SampleTraits<S>::toFloat(src[i]);
+}
+
+/**
+ * Converts float samples to S, clipping to the integer range
+ *
+ * @param dither Dither added before rounding, or nullptr to round plainly (ignored for float)
+ */
+template<SampleType S>
+void convert(std::span<const float> src, std::span<S> dst, TpdfDither* dither = nullptr) {
+    tb_assert(src.size() == dst.size());
+    if constexpr (detail::kDitherable<S>) {
+        if (dither != nullptr) {
+            for (std::size_t i = 0; i < src.size(); ++i)
+                dst[i] = detail::SampleTraits<S>::fromFloat(src[i], dither->next());
+            return;
+        }
+    }
+
+    for (std::size_t i = 0; i < src.size(); ++i)
+        dst[i] = detail::SampleTraits<S>::fromFloat(src[i], 0.f);
+}
+
+/**
+ * Converts and de-interleaves dst.getNumFrames() frames into planar float in one pass, e.g.
+ * straight into a FifoBuffer's writable region or a SampleRateConverter input buffer
+ *
+ * @param interleaved At least dst.getNumFrames() · dst.getNumChannels() samples
+ */
+template<SampleType S>
+void deinterleave(std::span<const S> interleaved, choc::buffer::ChannelArrayView<float> dst) {
+    const auto numChannels = static_cast<std::size_t>(dst.getNumChannels());
+    const auto numFrames = static_cast<std::size_t>(dst.getNumFrames());
+    tb_assert(interleaved.size() >= numFrames * numChannels);
+
+    for (std::size_t first = 0; first < numFrames; first += detail::kInterleaveBlock) {
+        const auto last = std::min(first + detail::kInterleaveBlock, numFrames);
+        for (std::size_t ch = 0; ch < numChannels; ++ch) {
+            auto* out = dst.getChannel(static_cast<choc::buffer::ChannelCount>(ch)).data.data;
+            const auto* in = interleaved.data() + ch;
+            for (auto f = first; f < last; ++f)
+                out[f] = detail::SampleTraits<S>::toFloat(in[f * numChannels]);
+        }
+    }
+}
+
+/**
+ * Converts and interleaves planar float into S in one pass
+ *
+ * @param interleaved At least src.getNumFrames() · src.getNumChannels() samples
+ * @param dither Dither added before rounding, or nullptr to round plainly (ignored for float)
+ */
+template<SampleType S>
+void interleave(choc::buffer::ChannelArrayView<float> src, std::span<S> interleaved, TpdfDither* dither = nullptr) {
+    const auto numChannels = static_cast<std::size_t>(src.getNumChannels());
+    const auto numFrames = static_cast<std::size_t>(src.getNumFrames());
+    tb_assert(interleaved.size() >= numFrames * numChannels);
+
+    // Dither is drawn in output order, so the sequence does not depend on the block size. The
+    // view's own channel pointer table is read directly, rather than per sample through getChannel()
+    if constexpr (detail::kDitherable<S>) {
+        if (dither != nullptr) {
+            const auto* const* channels = src.data.channels;
+            const auto offset = static_cast<std::size_t>(src.data.offset);
+            auto* out = interleaved.data();
+            for (auto f = offset; f < offset + numFrames; ++f)
+                for (std::size_t ch = 0; ch < numChannels; ++ch)
+                    *out++ = detail::SampleTraits<S>::fromFloat(channels[ch][f], dither->next());
+            return;
+        }
+    }
+
+    for (std::size_t first = 0; first < numFrames; first += detail::kInterleaveBlock) {
+        const auto last = std::min(first + detail::kInterleaveBlock, numFrames);
+        for (std::size_t ch = 0; ch < numChannels; ++ch) {
+            const auto* in = src.getChannel(static_cast<choc::buffer::ChannelCount>(ch)).data.data;
+            auto* out = interleaved.data() + ch;
+            for (auto f = first; f < last; ++f)
+                out[f * numChannels] = detail::SampleTraits<S>::fromFloat(in[f], 0.f);
+        }
+    }
+}
+
+/**
+ * Converts and de-interleaves as many frames as fit directly into a FifoBuffer, without an
+ * intermediate planar float copy
+ *
+ * @return The number of frames pushed
+ */
+template<SampleType S>
+int pushInterleaved(FifoBuffer<float>& fifo, std::span<const S> interleaved) {
+    tb_instrumentStage(FifoPush);
+    const auto region = fifo.getWritableRegion();
+    const auto numChannels = static_cast<std::size_t>(region.getNumChannels());
+    const auto numFrames = std::min(static_cast<std::size_t>(region.getNumFrames()), interleaved.size() / numChannels);
+
+    deinterleave(interleaved, region.getStart(static_cast<choc::buffer::FrameCount>(numFrames)));
+    fifo.commitWrite(static_cast<int>(numFrames));
+    return static_cast<int>(numFrames);
+}
+
+/**
+ * SpscFifoBuffer version of pushInterleaved(); producer thread only
+ *
+ * @return The number of frames pushed
+ */
+template<SampleType S>
+int pushInterleaved(SpscFifoBuffer<float>& fifo, std::span<const S> interleaved) {
+    tb_instrumentStage(FifoPush);
+    const auto regions = fifo.getWritableRegions();
+    const auto numChannels = static_cast<std::size_t>(regions.first.getNumChannels());
+    const auto numFrames = std::min(static_cast<std::size_t>(regions.getNumFrames()), interleaved.size() / numChannels);
+    const auto firstFrames = std::min(numFrames, static_cast<std::size_t>(regions.first.getNumFrames()));
+
+    deinterleave(interleaved, regions.first.getStart(static_cast<choc::buffer::FrameCount>(firstFrames)));
+    deinterleave(interleaved.subspan(firstFrames * numChannels),
+                 regions.second.getStart(static_cast<choc::buffer::FrameCount>(numFrames - firstFrames)));
+    fifo.commitWrite(static_cast<int>(numFrames));
+    return static_cast<int>(numFrames);
+}
+
+}
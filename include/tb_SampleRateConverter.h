@@ -1,16 +1,21 @@
 #pragma once
 
 #include "tb_Core.h"
+#include "tb_Instrumentation.h"
+#include "tb_ThreadPool.h"
 #include <samplerate.h>
 #include <choc_SampleBuffers.h>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 namespace tb {
 
 /**
  * C++ wrapper for libsamplerate using choc audio buffers.
- * Works with non-interleaved (planar) audio data only.
+ * Works with either non-interleaved (planar) or interleaved audio data, chosen at construction.
  */
 class SampleRateConverter {
 public:
@@ -25,23 +30,40 @@ public:
         Linear        = SRC_LINEAR                 // Fast, low quality
     };
 
+    /**
+     * Sample layout accepted by process()/processInterleaved()
+     */
+    enum class Layout {
+        Planar,       // process(): one libsamplerate state per channel
+        Interleaved   // processInterleaved(): one multi-channel state working on the frames directly
+    };
+
     /**
      * @param numChannels Number of audio channels (must be > 0)
      * @param quality Conversion quality
+     * @param layout Whether the converter is fed planar or interleaved buffers
      */
-    explicit SampleRateConverter(int numChannels, Quality quality) {
+    explicit SampleRateConverter(int numChannels, Quality quality, Layout layout = Layout::Planar) :
+        mQuality(quality), mLayout(layout), mNumChannels(numChannels) {
         tb_throwIf(numChannels <= 0);
 
-        // Create one converter per channel for independent processing
-        mConverters.reserve(numChannels);
-        for (int i = 0; i < numChannels; ++i) {
+        // Planar: one converter per channel for independent processing.
+        // Interleaved: a single converter that handles all channels of each frame
+        const auto numConverters = layout == Layout::Planar ? numChannels : 1;
+        const auto channelsPerConverter = layout == Layout::Planar ? 1 : numChannels;
+
+        mConverters.reserve(numConverters);
+        for (int i = 0; i < numConverters; ++i) {
             int error = 0;
-            SRC_STATE* state = src_new(static_cast<int>(quality), 1, &error);
+            SRC_STATE* state = src_new(static_cast<int>(quality), channelsPerConverter, &error);
             if (!state || error != 0)
                 tb_throw(std::string("Failed to create SRC state: ") + src_strerror(error));
 
             mConverters.emplace_back(state);
         }
+
+        mChannelData.resize(numConverters);
+        mChannelErrors.resize(numConverters);
     }
 
     ~SampleRateConverter() = default;
@@ -56,6 +78,10 @@ public:
      * This method determines how many input samples must be processed before
      * the converter begins producing non-zero output. This is useful for
      * compensating for algorithmic delay in real-time audio applications.
+     *
+     * libsamplerate does not expose its latency, so it is measured by probing a converter.
+     * Results are cached process-wide per (quality, ratio), so only the first query for a
+     * given combination pays for the probe. Safe to call from multiple threads.
      * 
      * @param quality The converter quality setting to measure
      * @param inSampleRate Input sample rate in Hz
@@ -63,26 +89,46 @@ public:
      * @return Number of input samples of latency at the input sample rate
      */
     static int getLatencyInSamples(Quality quality, double inSampleRate, double outSampleRate) {
-        SampleRateConverter src(1, quality);
-        
-        // Create i/o buffers, with 1 sample each
-        choc::buffer::ChannelArrayBuffer<float> input(1, 1);
-        choc::buffer::ChannelArrayBuffer<float> output(1, 1);
+        if (inSampleRate == outSampleRate)
+            return 0;  // process() copies straight through
 
-        for (int i = 0;; ++i) {
-            auto [in, out] = src.process(input, output, inSampleRate, outSampleRate);
-            if (out.getNumFrames() > 0)
-                return i;
+        static std::mutex mutex;
+        static std::map<std::pair<Quality, double>, int> cache;
+
+        const auto key = std::make_pair(quality, outSampleRate / inSampleRate);
+        {
+            std::lock_guard lock(mutex);
+            if (const auto it = cache.find(key); it != cache.end())
+                return it->second;
         }
+
+        // Probe without holding the lock, so queries for cached ratios never wait on a cold
+        // probe. Threads racing on the same key measure the same value, so either result is kept.
+        const auto latency = measureLatencyInSamples(quality, inSampleRate, outSampleRate);
+        std::lock_guard lock(mutex);
+        return cache.emplace(key, latency).first->second;
+    }
+
+    /**
+     * Same as the static getLatencyInSamples(), for this converter's quality setting
+     */
+    int getLatencyInSamples(double inSampleRate, double outSampleRate) const {
+        return getLatencyInSamples(mQuality, inSampleRate, outSampleRate);
     }
 
+    /**
+     * @return The quality set in the constructor
+     */
+    Quality getQuality() const noexcept { return mQuality; }
+
     struct Result {
         choc::buffer::ChannelArrayView<float> remainingInput;
         choc::buffer::ChannelArrayView<float> actualOutput;
     };
 
     /**
-     * Process audio using choc::buffer::ChannelArrayView (non-interleaved/planar)
+     * Process audio using choc::buffer::ChannelArrayView (non-interleaved/planar). Throws on a
+     * converter constructed with Layout::Interleaved
      * @param input Input buffer view (planar: separate channel buffers)
      * @param output Output buffer view (planar, must be pre-allocated)
      * @param inSampleRate Input sample rate in Hz
@@ -92,7 +138,9 @@ public:
      */
     Result process(choc::buffer::ChannelArrayView<float> input, choc::buffer::ChannelArrayView<float> output,
                    double inSampleRate, double outSampleRate, bool endOfInput = false) {
+        tb_instrumentStage(SrcProcess);
         tb_assert(! mConverters.empty() && inSampleRate > 0.0 && outSampleRate > 0.0);
+        tb_throwMsgIf(mLayout != Layout::Planar, "process() requires a Layout::Planar converter");
         tb_assert(input.getNumChannels() == getNumChannels() &&
                   output.getNumChannels() == getNumChannels());
 
@@ -105,25 +153,113 @@ public:
         }
 
         // Process each channel independently
-        SRC_DATA srcData = {};
         for (uint32_t ch = 0; ch < input.getNumChannels(); ++ch) {
+            auto& srcData = mChannelData[ch];
+            srcData = {};
             srcData.data_in = input.getChannel(ch).data.data;
             srcData.input_frames = static_cast<long>(input.getNumFrames());
             srcData.data_out = output.getChannel(ch).data.data;
             srcData.output_frames = static_cast<long>(output.getNumFrames());
             srcData.src_ratio = outSampleRate / inSampleRate;
             srcData.end_of_input = endOfInput ? 1 : 0;
+        }
+
+        auto processChannel = [this](int ch) {
+            mChannelErrors[ch] = src_process(mConverters[ch].get(), &mChannelData[ch]);
+        };
 
-            const int error = src_process(mConverters[ch].get(), &srcData);
+        const auto numSamples = static_cast<long>(input.getNumFrames()) * getNumChannels();
+        if (mThreadPool != nullptr && getNumChannels() > 1 && numSamples >= mMinSamplesForParallel)
+            mThreadPool->parallelFor(getNumChannels(), processChannel);
+        else
+            for (int ch = 0; ch < getNumChannels(); ++ch)
+                processChannel(ch);
+
+        for (const int error : mChannelErrors) {
             if (error != 0) {
                 tb_throwMsgIf(error != 0, std::string("SRC processing error: ") + src_strerror(error));
             }
         }
 
+        // Every channel sees the same ratio and frame counts, so they all advance identically
+        const auto& srcData = mChannelData.front();
         return { .remainingInput = input.fromFrame(srcData.input_frames_used),
                  .actualOutput = output.getStart(srcData.output_frames_gen) };
     }
 
+    struct InterleavedResult {
+        choc::buffer::InterleavedView<float> remainingInput;
+        choc::buffer::InterleavedView<float> actualOutput;
+    };
+
+    /**
+     * Process audio using choc::buffer::InterleavedView, without de-interleaving. Throws unless
+     * the converter was constructed with Layout::Interleaved. Both views must be packed (their stride
+     * equals the channel count), as libsamplerate reads whole frames
+     * @param input Input buffer view (interleaved)
+     * @param output Output buffer view (interleaved, must be pre-allocated)
+     * @param inSampleRate Input sample rate in Hz
+     * @param outSampleRate Output sample rate in Hz
+     * @param endOfInput True if this is the last buffer
+     * @return The unconsumed part of the input and the part of the output that was written
+     */
+    InterleavedResult processInterleaved(choc::buffer::InterleavedView<float> input,
+                                         choc::buffer::InterleavedView<float> output,
+                                         double inSampleRate, double outSampleRate,
+                                         bool endOfInput = false) {
+        tb_instrumentStage(SrcProcess);
+        tb_assert(! mConverters.empty() && inSampleRate > 0.0 && outSampleRate > 0.0);
+        tb_throwMsgIf(mLayout != Layout::Interleaved,
+                      "processInterleaved() requires a Layout::Interleaved converter");
+        tb_assert(input.getNumChannels() == getNumChannels() &&
+                  output.getNumChannels() == getNumChannels());
+        tb_assert(input.data.stride == input.getNumChannels() &&
+                  output.data.stride == output.getNumChannels());
+
+        if (outSampleRate == inSampleRate) {
+            const auto framesToCopy = std::min(input.getNumFrames(), output.getNumFrames());
+            choc::buffer::copy(output.getStart(framesToCopy), input.getStart(framesToCopy));
+
+            return { .remainingInput = input.fromFrame(framesToCopy),
+                     .actualOutput = output.getStart(framesToCopy) };
+        }
+
+        SRC_DATA srcData = {};
+        srcData.data_in = input.data.data;
+        srcData.input_frames = static_cast<long>(input.getNumFrames());
+        srcData.data_out = output.data.data;
+        srcData.output_frames = static_cast<long>(output.getNumFrames());
+        srcData.src_ratio = outSampleRate / inSampleRate;
+        srcData.end_of_input = endOfInput ? 1 : 0;
+
+        const int error = src_process(mConverters.front().get(), &srcData);
+        tb_throwMsgIf(error != 0, std::string("SRC processing error: ") + src_strerror(error));
+
+        return { .remainingInput = input.fromFrame(srcData.input_frames_used),
+                 .actualOutput = output.getStart(srcData.output_frames_gen) };
+    }
+
+    /**
+     * Runs the channels of subsequent process() calls concurrently on a thread pool. Throws on
+     * a Layout::Interleaved converter, whose single state cannot be split across threads.
+     *
+     * Each channel has its own converter state, so the output is identical to serial
+     * processing. process() does not create threads or allocate in either mode.
+     *
+     * @param threadPool Pool to run channels on (must outlive this converter), or nullptr to
+     *                   process serially
+     * @param minSamplesForParallel Blocks with fewer input samples (frames × channels) than
+     *                              this are still processed serially, as the hand-off to the
+     *                              pool would cost more than it saves
+     */
+    void setThreadPool(ThreadPool* threadPool, int minSamplesForParallel = 8192) {
+        tb_assert(minSamplesForParallel >= 0);
+        tb_throwMsgIf(threadPool != nullptr && mLayout != Layout::Planar,
+                      "setThreadPool() requires a Layout::Planar converter");
+        mThreadPool = threadPool;
+        mMinSamplesForParallel = minSamplesForParallel;
+    }
+
     /**
      * Reset the converter state for all channels
      */
@@ -137,7 +273,12 @@ public:
     /**
      * @return The number of channels set in the constructor
      */
-    int getNumChannels() const noexcept { return static_cast<int>(mConverters.size()); }
+    int getNumChannels() const noexcept { return mNumChannels; }
+
+    /**
+     * @return The layout set in the constructor
+     */
+    Layout getLayout() const noexcept { return mLayout; }
 
     /**
      * Get libsamplerate version string
@@ -145,6 +286,20 @@ public:
     static const char* getVersion() { return src_get_version(); }
 
 private:
+    static int measureLatencyInSamples(Quality quality, double inSampleRate, double outSampleRate) {
+        SampleRateConverter src(1, quality);
+        
+        // Create i/o buffers, with 1 sample each
+        choc::buffer::ChannelArrayBuffer<float> input(1, 1);
+        choc::buffer::ChannelArrayBuffer<float> output(1, 1);
+
+        for (int i = 0;; ++i) {
+            auto [in, out] = src.process(input, output, inSampleRate, outSampleRate);
+            if (out.getNumFrames() > 0)
+                return i;
+        }
+    }
+
     struct SRCStateDeleter {
         void operator()(SRC_STATE* state) const {
             if (state) {
@@ -153,7 +308,15 @@ private:
         }
     };
 
+    Quality mQuality;
+    Layout mLayout;
+    int mNumChannels = 0;
     std::vector<std::unique_ptr<SRC_STATE, SRCStateDeleter>> mConverters;
+    std::vector<SRC_DATA> mChannelData;
+    std::vector<int> mChannelErrors;
+
+    ThreadPool* mThreadPool = nullptr;
+    long mMinSamplesForParallel = 0;
 };
 
 }
\ No newline at end of file
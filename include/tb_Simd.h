@@ -0,0 +1,887 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Math.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TB_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && ! defined(__clang__)
+#include <intrin.h>
+#endif
+#else
+#define TB_SIMD_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TB_SIMD_TARGET(_ISA) __attribute__((target(_ISA)))
+#else
+#define TB_SIMD_TARGET(_ISA)
+#endif
+
+/**
+ * Vectorised kernels shared by the audio feature functions and the uniform Catmull-Rom spline,
+ * with runtime dispatch to the widest instruction set the CPU supports (SSE2 → AVX2 → AVX-512 on
+ * x86-64, a portable fallback everywhere else; the portable reductions are written as fixed-width
+ * lane loops so the compiler can map them onto NEON).
+ *
+ * Precision contract for the reductions: input is split into blocks of detail::kBlockSize elements. Inside a block
+ * each SIMD lane accumulates in float and the lanes are summed pairwise; block results are then
+ * accumulated in double. The error of a result is therefore bounded by roughly
+ * (kBlockSize / lanes + log2(lanes)) · FLT_EPSILON · Σ|term| for any input length, and results
+ * may differ in the last bits between instruction sets (but are deterministic for a given one).
+ */
+namespace tb::simd {
+
+enum class Isa {
+    Portable,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+struct IndexMoments {
+    double sum = 0.0;               // Σ x[i]
+    double indexWeightedSum = 0.0;  // Σ i · x[i]
+};
+
+struct PowerMoments {
+    double sum = 0.0;      // Σ p[i]
+    double sumX = 0.0;     // Σ x[i] · p[i]
+    double sumX2 = 0.0;    // Σ x[i]² · p[i]
+    double sumX3 = 0.0;    // Σ x[i]³ · p[i]
+    double sumX4 = 0.0;    // Σ x[i]⁴ · p[i]
+    double sumLog2 = 0.0;  // Σ log2(max(p[i], floor))
+    float peak = 0.f;      // max(p[i], 0)
+
+    void add(const PowerMoments& other) {
+        sum += other.sum;
+        sumX += other.sumX;
+        sumX2 += other.sumX2;
+        sumX3 += other.sumX3;
+        sumX4 += other.sumX4;
+        sumLog2 += other.sumLog2;
+        peak = std::max(peak, other.peak);
+    }
+};
+
+// Points of a uniform cubic spline segment computed together, see cubicSegments()
+inline constexpr std::size_t kCubicLanes = 4;
+
+/**
+ * Precomputed basis weights of a uniform cubic spline (e.g. uniform Catmull-Rom): point j of the
+ * segment over control points p0..p3 is w[0][j] · p0 + w[1][j] · p1 + w[2][j] · p2 + w[3][j] · p3
+ */
+struct CubicWeights {
+    const float* w[4] = {};  // pointsPerSegment weights each, zero-padded to a multiple of kCubicLanes
+    std::size_t pointsPerSegment = 0;
+};
+
+namespace detail {
+
+inline constexpr std::size_t kBlockSize = 256;
+
+// ── Portable ────────────────────────────────────────────────────────────────
+
+inline constexpr std::size_t kPortableLanes = 8;
+
+inline float sumLanes(const float (&lanes)[kPortableLanes]) {
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+           ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+inline float dotBlockPortable(const float* a, const float* b, std::size_t n) {
+    float acc[kPortableLanes] = {};
+    std::size_t i = 0;
+    for (; i + kPortableLanes <= n; i += kPortableLanes)
+        for (std::size_t l = 0; l < kPortableLanes; ++l)
+            acc[l] += a[i + l] * b[i + l];
+
+    auto sum = sumLanes(acc);
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+inline float positiveDifferenceBlockPortable(const float* prev, const float* curr, std::size_t n) {
+    float acc[kPortableLanes] = {};
+    std::size_t i = 0;
+    for (; i + kPortableLanes <= n; i += kPortableLanes)
+        for (std::size_t l = 0; l < kPortableLanes; ++l)
+            acc[l] += std::max(curr[i + l] - prev[i + l], 0.f);
+
+    auto sum = sumLanes(acc);
+    for (; i < n; ++i)
+        sum += std::max(curr[i] - prev[i], 0.f);
+    return sum;
+}
+
+inline void multiplyPortable(const float* a, const float* b, float* dst, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = a[i] * b[i];
+}
+
+inline void scaledLog2Portable(const float* x, float* dst, std::size_t n, float floor, float scale) {
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = scale * fastLog2(std::max(floor, x[i]));
+}
+
+inline IndexMoments momentsBlockPortable(const float* x, std::size_t n, float firstIndex) {
+    float sum[kPortableLanes] = {};
+    float weighted[kPortableLanes] = {};
+    std::size_t i = 0;
+    for (; i + kPortableLanes <= n; i += kPortableLanes) {
+        for (std::size_t l = 0; l < kPortableLanes; ++l) {
+            sum[l] += x[i + l];
+            weighted[l] += (firstIndex + static_cast<float>(i + l)) * x[i + l];
+        }
+    }
+
+    auto s = sumLanes(sum);
+    auto w = sumLanes(weighted);
+    for (; i < n; ++i) {
+        s += x[i];
+        w += (firstIndex + static_cast<float>(i)) * x[i];
+    }
+    return { s, w };
+}
+
+// The moments are accumulated in double (the raw fourth moment cancels badly in float), the
+// log2 sum in float lanes like the other reductions
+inline PowerMoments powerMomentsBlockPortable(const float* p, const double* x, std::size_t n, float floor) {
+    double sum[kPortableLanes] = {}, sumX[kPortableLanes] = {}, sumX2[kPortableLanes] = {};
+    double sumX3[kPortableLanes] = {}, sumX4[kPortableLanes] = {};
+    float sumLog2[kPortableLanes] = {}, peak[kPortableLanes] = {};
+
+    auto accumulate = [&](std::size_t l, std::size_t i) {
+        const double pi = p[i];
+        const auto xp = x[i] * pi;
+        const auto x2p = x[i] * xp;
+        const auto x3p = x[i] * x2p;
+        sum[l] += pi;
+        sumX[l] += xp;
+        sumX2[l] += x2p;
+        sumX3[l] += x3p;
+        sumX4[l] += x[i] * x3p;
+        sumLog2[l] += fastLog2(std::max(floor, p[i]));
+        peak[l] = std::max(peak[l], p[i]);
+    };
+
+    std::size_t i = 0;
+    for (; i + kPortableLanes <= n; i += kPortableLanes)
+        for (std::size_t l = 0; l < kPortableLanes; ++l)
+            accumulate(l, i + l);
+    for (; i < n; ++i)
+        accumulate(0, i);
+
+    PowerMoments m;
+    for (std::size_t l = 0; l < kPortableLanes; ++l)
+        m.add({ sum[l], sumX[l], sumX2[l], sumX3[l], sumX4[l], 0.0, peak[l] });
+    m.sumLog2 = sumLanes(sumLog2);
+    return m;
+}
+
+// Point j of the segment whose first control point is p[0], for control points stride floats apart
+inline float cubicPoint(const CubicWeights& c, std::size_t j, const float* p, std::size_t stride) {
+    return c.w[0][j] * p[0] + c.w[1][j] * p[stride] + c.w[2][j] * p[2 * stride] + c.w[3][j] * p[3 * stride];
+}
+
+inline void cubicPlanarPortable(const float* x, const float* y, std::size_t numSegments, const CubicWeights& c,
+                                float* outX, float* outY) {
+    const auto n = c.pointsPerSegment;
+    for (std::size_t s = 0; s < numSegments; ++s) {
+        for (std::size_t j = 0; j < n; ++j) {
+            outX[s * n + j] = cubicPoint(c, j, x + s, 1);
+            outY[s * n + j] = cubicPoint(c, j, y + s, 1);
+        }
+    }
+}
+
+inline void cubicInterleavedPortable(const float* xy, std::size_t numSegments, const CubicWeights& c, float* outXy) {
+    const auto n = c.pointsPerSegment;
+    for (std::size_t s = 0; s < numSegments; ++s) {
+        for (std::size_t j = 0; j < n; ++j) {
+            outXy[2 * (s * n + j)] = cubicPoint(c, j, xy + 2 * s, 2);
+            outXy[2 * (s * n + j) + 1] = cubicPoint(c, j, xy + 2 * s + 1, 2);
+        }
+    }
+}
+
+#if TB_SIMD_X86
+
+// ── SSE2 (baseline on x86-64) ───────────────────────────────────────────────
+
+inline float hsum128(__m128 v) {
+    const auto high = _mm_movehl_ps(v, v);
+    const auto pairs = _mm_add_ps(v, high);
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+inline float dotBlockSse2(const float* a, const float* b, std::size_t n) {
+    auto acc0 = _mm_setzero_ps();
+    auto acc1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    auto sum = hsum128(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+inline float positiveDifferenceBlockSse2(const float* prev, const float* curr, std::size_t n) {
+    const auto zero = _mm_setzero_ps();
+    auto acc0 = _mm_setzero_ps();
+    auto acc1 = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(curr + i), _mm_loadu_ps(prev + i)), zero));
+        acc1 = _mm_add_ps(acc1, _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(curr + i + 4), _mm_loadu_ps(prev + i + 4)), zero));
+    }
+
+    auto sum = hsum128(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i)
+        sum += std::max(curr[i] - prev[i], 0.f);
+    return sum;
+}
+
+inline void multiplySse2(const float* a, const float* b, float* dst, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    for (; i < n; ++i)
+        dst[i] = a[i] * b[i];
+}
+
+inline __m128 log2Sse2(__m128 x) {
+    const auto bits = _mm_castps_si128(x);
+    const auto exponent = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(tb::detail::kLog2MantissaOffset)), 23);
+    const auto f = _mm_sub_ps(_mm_castsi128_ps(_mm_sub_epi32(bits, _mm_slli_epi32(exponent, 23))), _mm_set1_ps(1.f));
+
+    auto p = _mm_set1_ps(tb::detail::kLog2Poly[5]);
+    for (int i = 4; i >= 0; --i)
+        p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(tb::detail::kLog2Poly[i]));
+    return _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_mul_ps(f, p));
+}
+
+inline void scaledLog2Sse2(const float* x, float* dst, std::size_t n, float floor, float scale) {
+    const auto floorV = _mm_set1_ps(floor);
+    const auto scaleV = _mm_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(scaleV, log2Sse2(_mm_max_ps(_mm_loadu_ps(x + i), floorV))));
+    for (; i < n; ++i)
+        dst[i] = scale * fastLog2(std::max(floor, x[i]));
+}
+
+inline IndexMoments momentsBlockSse2(const float* x, std::size_t n, float firstIndex) {
+    const auto step = _mm_set1_ps(4.f);
+    auto index = _mm_add_ps(_mm_set1_ps(firstIndex), _mm_setr_ps(0.f, 1.f, 2.f, 3.f));
+    auto sum = _mm_setzero_ps();
+    auto weighted = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const auto v = _mm_loadu_ps(x + i);
+        sum = _mm_add_ps(sum, v);
+        weighted = _mm_add_ps(weighted, _mm_mul_ps(index, v));
+        index = _mm_add_ps(index, step);
+    }
+
+    auto s = hsum128(sum);
+    auto w = hsum128(weighted);
+    for (; i < n; ++i) {
+        s += x[i];
+        w += (firstIndex + static_cast<float>(i)) * x[i];
+    }
+    return { s, w };
+}
+
+inline double hsum128d(__m128d v) { return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v))); }
+
+inline float hmax128(__m128 v) {
+    const auto pairs = _mm_max_ps(v, _mm_movehl_ps(v, v));
+    return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+// acc[j] += x^j · p, for j in [0, 4]
+inline void accumulateMomentsSse2(__m128d p, __m128d x, __m128d (&acc)[5]) {
+    for (auto& a : acc) {
+        a = _mm_add_pd(a, p);
+        p = _mm_mul_pd(p, x);
+    }
+}
+
+inline PowerMoments powerMomentsBlockSse2(const float* p, const double* x, std::size_t n, float floor) {
+    const auto floorV = _mm_set1_ps(floor);
+    __m128d acc[5] = {};
+    auto sumLog2 = _mm_setzero_ps(), peak = _mm_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const auto v = _mm_loadu_ps(p + i);
+        accumulateMomentsSse2(_mm_cvtps_pd(v), _mm_loadu_pd(x + i), acc);
+        accumulateMomentsSse2(_mm_cvtps_pd(_mm_movehl_ps(v, v)), _mm_loadu_pd(x + i + 2), acc);
+        sumLog2 = _mm_add_ps(sumLog2, log2Sse2(_mm_max_ps(v, floorV)));
+        peak = _mm_max_ps(peak, v);
+    }
+
+    PowerMoments m { hsum128d(acc[0]), hsum128d(acc[1]), hsum128d(acc[2]), hsum128d(acc[3]), hsum128d(acc[4]),
+                     hsum128(sumLog2), hmax128(peak) };
+    for (; i < n; ++i) {
+        const double pi = p[i];
+        m.add({ pi, x[i] * pi, x[i] * x[i] * pi, x[i] * x[i] * x[i] * pi, x[i] * x[i] * x[i] * x[i] * pi,
+                fastLog2(std::max(floor, p[i])), p[i] });
+    }
+    return m;
+}
+
+// Broadcasts of the four control points of the current segment, moved along one point per segment
+struct CubicWindowSse2 {
+    __m128 p0, p1, p2, p3;
+
+    CubicWindowSse2(const float* first, std::size_t stride) :
+        p0(_mm_set1_ps(first[0])), p1(_mm_set1_ps(first[stride])), p2(_mm_set1_ps(first[2 * stride])),
+        p3(_mm_set1_ps(first[3 * stride])) {}
+
+    void advance(float next) {
+        p0 = p1;
+        p1 = p2;
+        p2 = p3;
+        p3 = _mm_set1_ps(next);
+    }
+};
+
+inline __m128 cubicGroupSse2(const CubicWeights& c, std::size_t j, const CubicWindowSse2& p) {
+    return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(c.w[0] + j), p.p0),
+                                            _mm_mul_ps(_mm_loadu_ps(c.w[1] + j), p.p1)),
+                                 _mm_mul_ps(_mm_loadu_ps(c.w[2] + j), p.p2)),
+                      _mm_mul_ps(_mm_loadu_ps(c.w[3] + j), p.p3));
+}
+
+// A segment's points are contiguous, so they are computed kCubicLanes at a time and stored whole.
+// Where it stays inside the output, a segment's last group spills zero-weight points into the next
+// segment, which then overwrites them; otherwise the points past the last whole group are scalar.
+inline std::size_t cubicGroupsEnd(std::size_t s, std::size_t numSegments, std::size_t n) {
+    const auto padded = (n + kCubicLanes - 1) / kCubicLanes * kCubicLanes;
+    return s * n + padded <= numSegments * n ? n : n - n % kCubicLanes;
+}
+
+inline void cubicPlanarSse2(const float* x, const float* y, std::size_t numSegments, const CubicWeights& weights,
+                            float* outX, float* outY) {
+    const auto c = weights;  // A local copy, as the unaligned stores may alias the weight pointers
+    const auto n = c.pointsPerSegment;
+    CubicWindowSse2 px(x, 1), py(y, 1);
+    for (std::size_t s = 0; s < numSegments; ++s) {
+        if (s > 0) {
+            px.advance(x[s + 3]);
+            py.advance(y[s + 3]);
+        }
+
+        const auto groupsEnd = cubicGroupsEnd(s, numSegments, n);
+        std::size_t j = 0;
+        for (; j < groupsEnd; j += kCubicLanes) {
+            _mm_storeu_ps(outX + s * n + j, cubicGroupSse2(c, j, px));
+            _mm_storeu_ps(outY + s * n + j, cubicGroupSse2(c, j, py));
+        }
+        for (; j < n; ++j) {
+            outX[s * n + j] = cubicPoint(c, j, x + s, 1);
+            outY[s * n + j] = cubicPoint(c, j, y + s, 1);
+        }
+    }
+}
+
+inline void cubicInterleavedSse2(const float* xy, std::size_t numSegments, const CubicWeights& weights, float* outXy) {
+    const auto c = weights;  // A local copy, as the unaligned stores may alias the weight pointers
+    const auto n = c.pointsPerSegment;
+    CubicWindowSse2 px(xy, 2), py(xy + 1, 2);
+    for (std::size_t s = 0; s < numSegments; ++s) {
+        if (s > 0) {
+            px.advance(xy[2 * (s + 3)]);
+            py.advance(xy[2 * (s + 3) + 1]);
+        }
+
+        const auto groupsEnd = cubicGroupsEnd(s, numSegments, n);
+        std::size_t j = 0;
+        for (; j < groupsEnd; j += kCubicLanes) {
+            const auto vx = cubicGroupSse2(c, j, px);
+            const auto vy = cubicGroupSse2(c, j, py);
+            _mm_storeu_ps(outXy + 2 * (s * n + j), _mm_unpacklo_ps(vx, vy));
+            _mm_storeu_ps(outXy + 2 * (s * n + j) + 4, _mm_unpackhi_ps(vx, vy));
+        }
+        for (; j < n; ++j) {
+            outXy[2 * (s * n + j)] = cubicPoint(c, j, xy + 2 * s, 2);
+            outXy[2 * (s * n + j) + 1] = cubicPoint(c, j, xy + 2 * s + 1, 2);
+        }
+    }
+}
+
+// ── AVX2 ────────────────────────────────────────────────────────────────────
+
+TB_SIMD_TARGET("avx2") inline float hsum256(__m256 v) {
+    return hsum128(_mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)));
+}
+
+TB_SIMD_TARGET("avx2") inline float dotBlockAvx2(const float* a, const float* b, std::size_t n) {
+    auto acc0 = _mm256_setzero_ps();
+    auto acc1 = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8)
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+
+    auto sum = hsum256(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+TB_SIMD_TARGET("avx2")
+inline float positiveDifferenceBlockAvx2(const float* prev, const float* curr, std::size_t n) {
+    const auto zero = _mm256_setzero_ps();
+    auto acc = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm256_add_ps(acc, _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(curr + i), _mm256_loadu_ps(prev + i)), zero));
+
+    auto sum = hsum256(acc);
+    for (; i < n; ++i)
+        sum += std::max(curr[i] - prev[i], 0.f);
+    return sum;
+}
+
+TB_SIMD_TARGET("avx2") inline void multiplyAvx2(const float* a, const float* b, float* dst, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    for (; i < n; ++i)
+        dst[i] = a[i] * b[i];
+}
+
+TB_SIMD_TARGET("avx2") inline __m256 log2Avx2(__m256 x) {
+    const auto bits = _mm256_castps_si256(x);
+    const auto exponent = _mm256_srai_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32(tb::detail::kLog2MantissaOffset)), 23);
+    const auto f = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_sub_epi32(bits, _mm256_slli_epi32(exponent, 23))),
+                                 _mm256_set1_ps(1.f));
+
+    auto p = _mm256_set1_ps(tb::detail::kLog2Poly[5]);
+    for (int i = 4; i >= 0; --i)
+        p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(tb::detail::kLog2Poly[i]));
+    return _mm256_add_ps(_mm256_cvtepi32_ps(exponent), _mm256_mul_ps(f, p));
+}
+
+TB_SIMD_TARGET("avx2")
+inline void scaledLog2Avx2(const float* x, float* dst, std::size_t n, float floor, float scale) {
+    const auto floorV = _mm256_set1_ps(floor);
+    const auto scaleV = _mm256_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(scaleV, log2Avx2(_mm256_max_ps(_mm256_loadu_ps(x + i), floorV))));
+    for (; i < n; ++i)
+        dst[i] = scale * fastLog2(std::max(floor, x[i]));
+}
+
+TB_SIMD_TARGET("avx2")
+inline IndexMoments momentsBlockAvx2(const float* x, std::size_t n, float firstIndex) {
+    const auto step = _mm256_set1_ps(8.f);
+    auto index = _mm256_add_ps(_mm256_set1_ps(firstIndex),
+                               _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f));
+    auto sum = _mm256_setzero_ps();
+    auto weighted = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const auto v = _mm256_loadu_ps(x + i);
+        sum = _mm256_add_ps(sum, v);
+        weighted = _mm256_add_ps(weighted, _mm256_mul_ps(index, v));
+        index = _mm256_add_ps(index, step);
+    }
+
+    auto s = hsum256(sum);
+    auto w = hsum256(weighted);
+    for (; i < n; ++i) {
+        s += x[i];
+        w += (firstIndex + static_cast<float>(i)) * x[i];
+    }
+    return { s, w };
+}
+
+TB_SIMD_TARGET("avx2") inline double hsum256d(__m256d v) {
+    return hsum128d(_mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)));
+}
+
+// acc[j] += x^j · p, for j in [0, 4]
+TB_SIMD_TARGET("avx2")
+inline void accumulateMomentsAvx2(__m256d p, __m256d x, __m256d (&acc)[5]) {
+    for (auto& a : acc) {
+        a = _mm256_add_pd(a, p);
+        p = _mm256_mul_pd(p, x);
+    }
+}
+
+TB_SIMD_TARGET("avx2")
+inline PowerMoments powerMomentsBlockAvx2(const float* p, const double* x, std::size_t n, float floor) {
+    const auto floorV = _mm256_set1_ps(floor);
+    __m256d acc[5] = {};
+    auto sumLog2 = _mm256_setzero_ps(), peak = _mm256_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const auto v = _mm256_loadu_ps(p + i);
+        accumulateMomentsAvx2(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), _mm256_loadu_pd(x + i), acc);
+        accumulateMomentsAvx2(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), _mm256_loadu_pd(x + i + 4), acc);
+        sumLog2 = _mm256_add_ps(sumLog2, log2Avx2(_mm256_max_ps(v, floorV)));
+        peak = _mm256_max_ps(peak, v);
+    }
+
+    PowerMoments m { hsum256d(acc[0]), hsum256d(acc[1]), hsum256d(acc[2]), hsum256d(acc[3]), hsum256d(acc[4]),
+                     hsum256(sumLog2),
+                     hmax128(_mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1))) };
+    m.add(powerMomentsBlockSse2(p + i, x + i, n - i, floor));
+    return m;
+}
+
+// ── AVX-512 ─────────────────────────────────────────────────────────────────
+
+TB_SIMD_TARGET("avx512f") inline float dotBlockAvx512(const float* a, const float* b, std::size_t n) {
+    auto acc = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+
+    auto sum = _mm512_reduce_add_ps(acc);
+    for (; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+TB_SIMD_TARGET("avx512f")
+inline float positiveDifferenceBlockAvx512(const float* prev, const float* curr, std::size_t n) {
+    const auto zero = _mm512_setzero_ps();
+    auto acc = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        acc = _mm512_add_ps(acc, _mm512_max_ps(_mm512_sub_ps(_mm512_loadu_ps(curr + i), _mm512_loadu_ps(prev + i)), zero));
+
+    auto sum = _mm512_reduce_add_ps(acc);
+    for (; i < n; ++i)
+        sum += std::max(curr[i] - prev[i], 0.f);
+    return sum;
+}
+
+TB_SIMD_TARGET("avx512f")
+inline void multiplyAvx512(const float* a, const float* b, float* dst, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i)));
+    for (; i < n; ++i)
+        dst[i] = a[i] * b[i];
+}
+
+TB_SIMD_TARGET("avx512f") inline __m512 log2Avx512(__m512 x) {
+    const auto bits = _mm512_castps_si512(x);
+    const auto exponent = _mm512_srai_epi32(_mm512_sub_epi32(bits, _mm512_set1_epi32(tb::detail::kLog2MantissaOffset)), 23);
+    const auto f = _mm512_sub_ps(_mm512_castsi512_ps(_mm512_sub_epi32(bits, _mm512_slli_epi32(exponent, 23))),
+                                 _mm512_set1_ps(1.f));
+
+    auto p = _mm512_set1_ps(tb::detail::kLog2Poly[5]);
+    for (int i = 4; i >= 0; --i)
+        p = _mm512_add_ps(_mm512_mul_ps(p, f), _mm512_set1_ps(tb::detail::kLog2Poly[i]));
+    return _mm512_add_ps(_mm512_cvtepi32_ps(exponent), _mm512_mul_ps(f, p));
+}
+
+TB_SIMD_TARGET("avx512f")
+inline void scaledLog2Avx512(const float* x, float* dst, std::size_t n, float floor, float scale) {
+    const auto floorV = _mm512_set1_ps(floor);
+    const auto scaleV = _mm512_set1_ps(scale);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(scaleV, log2Avx512(_mm512_max_ps(_mm512_loadu_ps(x + i), floorV))));
+    for (; i < n; ++i)
+        dst[i] = scale * fastLog2(std::max(floor, x[i]));
+}
+
+TB_SIMD_TARGET("avx512f")
+inline IndexMoments momentsBlockAvx512(const float* x, std::size_t n, float firstIndex) {
+    const auto step = _mm512_set1_ps(16.f);
+    auto index = _mm512_add_ps(_mm512_set1_ps(firstIndex),
+                               _mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f,
+                                              10.f, 11.f, 12.f, 13.f, 14.f, 15.f));
+    auto sum = _mm512_setzero_ps();
+    auto weighted = _mm512_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm512_loadu_ps(x + i);
+        sum = _mm512_add_ps(sum, v);
+        weighted = _mm512_add_ps(weighted, _mm512_mul_ps(index, v));
+        index = _mm512_add_ps(index, step);
+    }
+
+    auto s = _mm512_reduce_add_ps(sum);
+    auto w = _mm512_reduce_add_ps(weighted);
+    for (; i < n; ++i) {
+        s += x[i];
+        w += (firstIndex + static_cast<float>(i)) * x[i];
+    }
+    return { s, w };
+}
+
+// acc[j] += x^j · p, for j in [0, 4]
+TB_SIMD_TARGET("avx512f")
+inline void accumulateMomentsAvx512(__m512d p, __m512d x, __m512d (&acc)[5]) {
+    for (auto& a : acc) {
+        a = _mm512_add_pd(a, p);
+        p = _mm512_mul_pd(p, x);
+    }
+}
+
+TB_SIMD_TARGET("avx512f")
+inline PowerMoments powerMomentsBlockAvx512(const float* p, const double* x, std::size_t n, float floor) {
+    const auto floorV = _mm512_set1_ps(floor);
+    __m512d acc[5] = {};
+    auto sumLog2 = _mm512_setzero_ps(), peak = _mm512_setzero_ps();
+
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const auto v = _mm512_loadu_ps(p + i);
+        const auto high = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1));
+        accumulateMomentsAvx512(_mm512_cvtps_pd(_mm512_castps512_ps256(v)), _mm512_loadu_pd(x + i), acc);
+        accumulateMomentsAvx512(_mm512_cvtps_pd(high), _mm512_loadu_pd(x + i + 8), acc);
+        sumLog2 = _mm512_add_ps(sumLog2, log2Avx512(_mm512_max_ps(v, floorV)));
+        peak = _mm512_max_ps(peak, v);
+    }
+
+    PowerMoments m { _mm512_reduce_add_pd(acc[0]), _mm512_reduce_add_pd(acc[1]), _mm512_reduce_add_pd(acc[2]),
+                     _mm512_reduce_add_pd(acc[3]), _mm512_reduce_add_pd(acc[4]), _mm512_reduce_add_ps(sumLog2),
+                     _mm512_reduce_max_ps(peak) };
+    m.add(powerMomentsBlockSse2(p + i, x + i, n - i, floor));
+    return m;
+}
+
+inline bool cpuSupports(Isa isa) {
+#if defined(_MSC_VER) && ! defined(__clang__)
+    int info[4] = {};
+    __cpuid(info, 1);
+    const bool osSavesAvx = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    if (isa == Isa::Avx2)
+        return osSavesAvx && (info[1] & (1 << 5));
+    if (isa == Isa::Avx512)
+        return osSavesAvx && (info[1] & (1 << 16)) && (_xgetbv(0) & 0xe0) == 0xe0;
+    return true;
+#else
+    if (isa == Isa::Avx2)
+        return __builtin_cpu_supports("avx2");
+    if (isa == Isa::Avx512)
+        return __builtin_cpu_supports("avx512f");
+    return true;
+#endif
+}
+
+#else
+
+inline bool cpuSupports(Isa isa) { return isa == Isa::Portable; }
+
+#endif
+
+// ── Dispatch ────────────────────────────────────────────────────────────────
+
+struct Kernels {
+    Isa isa;
+    float (*dot)(const float*, const float*, std::size_t);
+    float (*positiveDifference)(const float*, const float*, std::size_t);
+    IndexMoments (*moments)(const float*, std::size_t, float);
+    void (*multiply)(const float*, const float*, float*, std::size_t);
+    void (*scaledLog2)(const float*, float*, std::size_t, float, float);
+    PowerMoments (*powerMoments)(const float*, const double*, std::size_t, float);
+    void (*cubicPlanar)(const float*, const float*, std::size_t, const CubicWeights&, float*, float*);
+    void (*cubicInterleaved)(const float*, std::size_t, const CubicWeights&, float*);
+};
+
+inline const Kernels& kernelsFor([[maybe_unused]] Isa isa) {
+    static constexpr Kernels portable { Isa::Portable, dotBlockPortable,
+                                        positiveDifferenceBlockPortable, momentsBlockPortable,
+                                        multiplyPortable, scaledLog2Portable,
+                                        powerMomentsBlockPortable, cubicPlanarPortable,
+                                        cubicInterleavedPortable };
+#if TB_SIMD_X86
+    static constexpr Kernels sse2 { Isa::Sse2, dotBlockSse2, positiveDifferenceBlockSse2,
+                                    momentsBlockSse2, multiplySse2, scaledLog2Sse2,
+                                    powerMomentsBlockSse2, cubicPlanarSse2, cubicInterleavedSse2 };
+    // The cubic spline kernels stay at SSE2 width: a segment rarely has more than a few points, and
+    // wider groups would mostly spill
+    static constexpr Kernels avx2 { Isa::Avx2, dotBlockAvx2, positiveDifferenceBlockAvx2,
+                                    momentsBlockAvx2, multiplyAvx2, scaledLog2Avx2,
+                                    powerMomentsBlockAvx2, cubicPlanarSse2, cubicInterleavedSse2 };
+    static constexpr Kernels avx512 { Isa::Avx512, dotBlockAvx512, positiveDifferenceBlockAvx512,
+                                      momentsBlockAvx512, multiplyAvx512, scaledLog2Avx512,
+                                      powerMomentsBlockAvx512, cubicPlanarSse2, cubicInterleavedSse2 };
+    switch (isa) {
+    case Isa::Portable: return portable;
+    case Isa::Sse2: return sse2;
+    case Isa::Avx2: return avx2;
+    case Isa::Avx512: return avx512;
+    }
+#endif
+    return portable;
+}
+
+inline Isa bestSupportedIsa() {
+    for (auto isa : { Isa::Avx512, Isa::Avx2, Isa::Sse2 })
+        if (cpuSupports(isa))
+            return isa;
+    return Isa::Portable;
+}
+
+inline std::atomic<const Kernels*>& activeKernels() {
+    static std::atomic<const Kernels*> kernels { &kernelsFor(bestSupportedIsa()) };
+    return kernels;
+}
+
+inline const Kernels& kernels() { return *activeKernels().load(std::memory_order_relaxed); }
+
+}
+
+/**
+ * @return True if the running CPU (and OS) can execute kernels for the given instruction set
+ */
+inline bool isSupported(Isa isa) { return detail::cpuSupports(isa); }
+
+/**
+ * @return The instruction set the kernels currently dispatch to
+ */
+inline Isa getIsa() { return detail::kernels().isa; }
+
+/**
+ * Forces dispatch to a specific instruction set, e.g. for testing or benchmarking. Unsupported
+ * instruction sets fall back to the best supported one.
+ *
+ * @return The instruction set actually selected
+ */
+inline Isa setIsa(Isa isa) {
+    if (! isSupported(isa))
+        isa = detail::bestSupportedIsa();
+    detail::activeKernels().store(&detail::kernelsFor(isa), std::memory_order_relaxed);
+    return isa;
+}
+
+/**
+ * @return Σ a[i] · b[i]
+ */
+inline double dot(std::span<const float> a, std::span<const float> b) {
+    tb_assert(a.size() == b.size());
+    const auto& k = detail::kernels();
+    double total = 0.0;
+    for (std::size_t i = 0; i < a.size(); i += detail::kBlockSize)
+        total += k.dot(a.data() + i, b.data() + i, std::min(detail::kBlockSize, a.size() - i));
+    return total;
+}
+
+/**
+ * @return Σ x[i]²
+ */
+inline double sumOfSquares(std::span<const float> x) { return dot(x, x); }
+
+/**
+ * @return Σ max(curr[i] - prev[i], 0)
+ */
+inline double positiveDifferenceSum(std::span<const float> prev, std::span<const float> curr) {
+    tb_assert(prev.size() == curr.size());
+    const auto& k = detail::kernels();
+    double total = 0.0;
+    for (std::size_t i = 0; i < curr.size(); i += detail::kBlockSize)
+        total += k.positiveDifference(prev.data() + i, curr.data() + i,
+                                      std::min(detail::kBlockSize, curr.size() - i));
+    return total;
+}
+
+/**
+ * @return Σ x[i] and Σ i · x[i]
+ */
+inline IndexMoments indexMoments(std::span<const float> x) {
+    const auto& k = detail::kernels();
+    IndexMoments total;
+    for (std::size_t i = 0; i < x.size(); i += detail::kBlockSize) {
+        const auto block = k.moments(x.data() + i, std::min(detail::kBlockSize, x.size() - i),
+                                     static_cast<float>(i));
+        total.sum += block.sum;
+        total.indexWeightedSum += block.indexWeightedSum;
+    }
+    return total;
+}
+
+/**
+ * Power-weighted raw moments of x, plus the log2 sum and peak of the power, in one pass (e.g. the
+ * spectral shape descriptors, with x the bin frequencies). The moments are accumulated in double;
+ * the log2 sum uses fastLog2() and float lanes, like the other reductions.
+ *
+ * @param floor Lower bound for the power inside the log (a positive, normal float)
+ */
+inline PowerMoments powerMoments(std::span<const float> power, std::span<const double> x, float floor) {
+    tb_assert(power.size() == x.size());
+    tb_assert(floor >= std::numeric_limits<float>::min());
+    const auto& k = detail::kernels();
+    PowerMoments total;
+    for (std::size_t i = 0; i < power.size(); i += detail::kBlockSize)
+        total.add(k.powerMoments(power.data() + i, x.data() + i, std::min(detail::kBlockSize, power.size() - i), floor));
+    return total;
+}
+
+/**
+ * dst[i] = a[i] · b[i]. dst may be the same memory as a or b (but must not partially overlap)
+ */
+inline void multiply(std::span<const float> a, std::span<const float> b, std::span<float> dst) {
+    tb_assert(a.size() == b.size() && a.size() == dst.size());
+    detail::kernels().multiply(a.data(), b.data(), dst.data(), dst.size());
+}
+
+/**
+ * dst[i] = scale · log2(max(x[i], floor)), using the fastLog2() approximation (absolute error
+ * below 5e-6 before scaling). floor must be a positive, normal float; it also maps zeros,
+ * negatives and NaNs to log2(floor). dst may be the same memory as x.
+ */
+inline void scaledLog2(std::span<const float> x, std::span<float> dst, float floor, float scale = 1.f) {
+    tb_assert(x.size() == dst.size());
+    tb_assert(floor >= std::numeric_limits<float>::min());
+    detail::kernels().scaledLog2(x.data(), dst.data(), dst.size(), floor, scale);
+}
+
+/**
+ * Evaluates a uniform cubic spline, one segment per window of four consecutive control points:
+ * segment s (over control points s..s + 3) writes its c.pointsPerSegment points from
+ * out[s · c.pointsPerSegment] on. A segment's points are contiguous, so they are computed
+ * kCubicLanes at a time.
+ *
+ * @param x, y Control points (at least 4)
+ * @param outX, outY (x.size() - 3) · c.pointsPerSegment points
+ */
+inline void cubicSegments(std::span<const float> x, std::span<const float> y, const CubicWeights& c,
+                          std::span<float> outX, std::span<float> outY) {
+    tb_assert(x.size() == y.size() && x.size() >= 4);
+    tb_assert(outX.size() == (x.size() - 3) * c.pointsPerSegment && outY.size() == outX.size());
+    detail::kernels().cubicPlanar(x.data(), y.data(), x.size() - 3, c, outX.data(), outY.data());
+}
+
+/**
+ * cubicSegments() for interleaved x, y pairs
+ *
+ * @param xy Control points as x, y pairs (at least 4 pairs)
+ * @param outXy (xy.size() / 2 - 3) · c.pointsPerSegment x, y pairs
+ */
+inline void cubicSegmentsInterleaved(std::span<const float> xy, const CubicWeights& c, std::span<float> outXy) {
+    tb_assert(xy.size() % 2 == 0 && xy.size() >= 8);
+    tb_assert(outXy.size() == (xy.size() / 2 - 3) * c.pointsPerSegment * 2);
+    detail::kernels().cubicInterleaved(xy.data(), xy.size() / 2 - 3, c, outXy.data());
+}
+
+}
@@ -1,6 +1,13 @@
-
 #pragma once
 
+#include "tb_Core.h"
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
 namespace tb {
 
 struct Point {
@@ -10,4 +17,148 @@ struct Point {
     float y = 0.f;
 };
 
-}
\ No newline at end of file
+/**
+ * std::allocator replacement that aligns every allocation to Alignment bytes (a cache line by
+ * default, which also covers every SIMD register width)
+ */
+template<typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t { Alignment }));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t { Alignment }); }
+
+    friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) noexcept { return true; }
+};
+
+/**
+ * Non-owning structure-of-arrays view of points: x[i] and y[i] make point i.
+ *
+ * Points stored this way can be processed a full SIMD register of x (or y) values at a time, and
+ * the view can wrap any storage, such as a PointBuffer or arena memory reused across frames.
+ */
+template<typename T>
+struct BasicPointSpan {
+    static_assert(std::is_same_v<std::remove_const_t<T>, float>);
+
+    BasicPointSpan() = default;
+    BasicPointSpan(std::span<T> xValues, std::span<T> yValues) : x(xValues), y(yValues) {
+        tb_assert(x.size() == y.size());
+    }
+
+    // Mutable → const view
+    template<typename U>
+        requires(std::is_const_v<T> && std::is_same_v<U, float>)
+    BasicPointSpan(const BasicPointSpan<U>& other) : x(other.x), y(other.y) {}
+
+    std::size_t size() const noexcept { return x.size(); }
+    bool empty() const noexcept { return x.empty(); }
+    Point operator[](std::size_t i) const { return Point(x[i], y[i]); }
+
+    BasicPointSpan subspan(std::size_t offset, std::size_t count) const {
+        return { x.subspan(offset, count), y.subspan(offset, count) };
+    }
+
+    std::span<T> x;
+    std::span<T> y;
+};
+
+using PointSpan = BasicPointSpan<float>;
+using ConstPointSpan = BasicPointSpan<const float>;
+
+/**
+ * Converts array-of-structures points to structure-of-arrays (dst must be the same size)
+ */
+inline void copyPoints(std::span<const Point> src, PointSpan dst) {
+    tb_assert(src.size() == dst.size());
+    for (std::size_t i = 0; i < src.size(); ++i) {
+        dst.x[i] = src[i].x;
+        dst.y[i] = src[i].y;
+    }
+}
+
+/**
+ * Converts structure-of-arrays points to array-of-structures (dst must be the same size)
+ */
+inline void copyPoints(ConstPointSpan src, std::span<Point> dst) {
+    tb_assert(src.size() == dst.size());
+    for (std::size_t i = 0; i < src.size(); ++i)
+        dst[i] = Point(src.x[i], src.y[i]);
+}
+
+/**
+ * Maps every point in place to (x · scaleX + offsetX, y · scaleY + offsetY), e.g. from data to
+ * pixel coordinates
+ */
+inline void transform(PointSpan points, float scaleX, float offsetX, float scaleY, float offsetY) {
+    for (auto& x : points.x)
+        x = x * scaleX + offsetX;
+    for (auto& y : points.y)
+        y = y * scaleY + offsetY;
+}
+
+/**
+ * Owning structure-of-arrays point storage, with x and y each in their own 64-byte aligned array.
+ *
+ * resize() within the reserved capacity never reallocates, so one buffer can be reused for every
+ * frame of a display.
+ */
+class PointBuffer {
+  public:
+    PointBuffer() = default;
+    explicit PointBuffer(std::size_t size) : mX(size), mY(size) {}
+    explicit PointBuffer(std::span<const Point> points) : PointBuffer(points.size()) { copyPoints(points, *this); }
+
+    void resize(std::size_t size) {
+        mX.resize(size);
+        mY.resize(size);
+    }
+
+    void reserve(std::size_t capacity) {
+        mX.reserve(capacity);
+        mY.reserve(capacity);
+    }
+
+    std::size_t size() const noexcept { return mX.size(); }
+    bool empty() const noexcept { return mX.empty(); }
+
+    std::span<float> x() noexcept { return mX; }
+    std::span<const float> x() const noexcept { return mX; }
+    std::span<float> y() noexcept { return mY; }
+    std::span<const float> y() const noexcept { return mY; }
+
+    Point operator[](std::size_t i) const { return Point(mX[i], mY[i]); }
+
+    void set(std::size_t i, Point point) {
+        mX[i] = point.x;
+        mY[i] = point.y;
+    }
+
+    operator PointSpan() noexcept { return { mX, mY }; }
+    operator ConstPointSpan() const noexcept { return { std::span<const float>(mX), std::span<const float>(mY) }; }
+
+    std::vector<Point> toPoints() const {
+        std::vector<Point> points(size());
+        copyPoints(*this, points);
+        return points;
+    }
+
+  private:
+    std::vector<float, AlignedAllocator<float>> mX;
+    std::vector<float, AlignedAllocator<float>> mY;
+};
+
+}
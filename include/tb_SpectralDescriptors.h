@@ -0,0 +1,145 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Shape descriptors of one power spectrum. Frequencies are in Hz.
+ */
+struct SpectralDescriptors {
+    float centroid = 0.f;   // Power-weighted mean frequency
+    float spread = 0.f;     // Power-weighted standard deviation around the centroid
+    float skewness = 0.f;   // Third standardised moment (> 0: tail towards high frequencies)
+    float kurtosis = 0.f;   // Fourth standardised moment (3 for a Gaussian-shaped spectrum)
+    float rolloff = 0.f;    // Frequency below which rolloffFraction of the power lies
+    float flatness = 0.f;   // Geometric / arithmetic mean of the power, in [0, 1] (1: white)
+    float crest = 0.f;      // Peak / arithmetic mean of the power
+    float bandwidth = 0.f;  // Width of the band holding the central occupiedFraction of the power
+};
+
+/**
+ * Computes every SpectralDescriptors field of a one-sided power spectrum in a single pass.
+ *
+ * The bin frequency table is built once in the constructor. process() walks the spectrum in
+ * blocks of kBlockSize bins through the simd::powerMoments() kernel, which accumulates the raw
+ * frequency moments (in double), the log2 sum (with fastLog2(), for the flatness), the peak and
+ * the total power in one vectorised pass, and remembers the power of each block. Rolloff and
+ * bandwidth are then located from those block sums, so finding them only rescans the single
+ * block each edge falls in.
+ *
+ * process() does not allocate, so one analyser per stream can run on the audio thread.
+ */
+class SpectralDescriptorAnalyser {
+  public:
+    static constexpr std::size_t kBlockSize = 64;
+
+    /**
+     * @param numBins Spectrum length (frameSize / 2 + 1, must be >= 2)
+     * @param sampleRate Sample rate of the analysed signal in Hz
+     * @param rolloffFraction Share of the total power below the rolloff frequency
+     * @param occupiedFraction Share of the total power inside the occupied bandwidth
+     */
+    SpectralDescriptorAnalyser(std::size_t numBins, double sampleRate, double rolloffFraction = 0.85,
+                               double occupiedFraction = 0.99) :
+        mNyquist(sampleRate / 2.0),
+        mRolloffFraction(rolloffFraction),
+        mOccupiedFraction(occupiedFraction),
+        mFrequencies(numBins),
+        mBlockPower((numBins + kBlockSize - 1) / kBlockSize) {
+        tb_throwIf(numBins < 2);
+        tb_throwIf(sampleRate <= 0.0);
+        tb_throwIf(rolloffFraction <= 0.0 || rolloffFraction > 1.0);
+        tb_throwIf(occupiedFraction <= 0.0 || occupiedFraction > 1.0);
+
+        // Normalised to [0, 1] (bin / nyquist bin) so the fourth powers stay well scaled
+        for (std::size_t k = 0; k < numBins; ++k)
+            mFrequencies[k] = static_cast<double>(k) / static_cast<double>(numBins - 1);
+    }
+
+    std::size_t getNumBins() const noexcept { return mFrequencies.size(); }
+
+    /**
+     * @param power One-sided power spectrum, getNumBins() long
+     * @return All descriptors (all zero for a silent frame)
+     */
+    SpectralDescriptors process(std::span<const float> power) {
+        tb_assert(power.size() == mFrequencies.size());
+
+        simd::PowerMoments moments;
+        for (std::size_t block = 0; block < mBlockPower.size(); ++block) {
+            const auto begin = block * kBlockSize;
+            const auto length = std::min(kBlockSize, power.size() - begin);
+            const auto blockMoments = simd::powerMoments(power.subspan(begin, length),
+                                                         std::span(mFrequencies).subspan(begin, length), kFloor);
+            mBlockPower[block] = blockMoments.sum;
+            moments.add(blockMoments);
+        }
+
+        const auto numBins = power.size();
+        const auto totalPower = moments.sum;
+        if (totalPower <= 0.0)
+            return {};
+
+        // Raw → central moments, in normalised frequency
+        const auto m1 = moments.sumX / totalPower;
+        const auto m2 = moments.sumX2 / totalPower;
+        const auto m3 = moments.sumX3 / totalPower;
+        const auto m4 = moments.sumX4 / totalPower;
+        const auto variance = std::max(m2 - m1 * m1, 0.0);
+        const auto central3 = m3 - 3.0 * m1 * m2 + 2.0 * m1 * m1 * m1;
+        const auto central4 = m4 - 4.0 * m1 * m3 + 6.0 * m1 * m1 * m2 - 3.0 * m1 * m1 * m1 * m1;
+        const auto sigma = std::sqrt(variance);
+
+        const auto mean = totalPower / static_cast<double>(numBins);
+
+        const auto lowerTail = (1.0 - mOccupiedFraction) * 0.5;
+        const auto lower = frequencyAtCumulativePower(power, lowerTail * totalPower);
+        const auto upper = frequencyAtCumulativePower(power, (1.0 - lowerTail) * totalPower);
+
+        SpectralDescriptors d;
+        d.centroid = static_cast<float>(m1 * mNyquist);
+        d.spread = static_cast<float>(sigma * mNyquist);
+        d.skewness = sigma > 0.0 ? static_cast<float>(central3 / (variance * sigma)) : 0.f;
+        d.kurtosis = sigma > 0.0 ? static_cast<float>(std::max(central4, 0.0) / (variance * variance)) : 0.f;
+        d.rolloff = static_cast<float>(frequencyAtCumulativePower(power, mRolloffFraction * totalPower));
+        d.flatness = static_cast<float>(std::min(std::exp2(moments.sumLog2 / static_cast<double>(numBins)) / mean, 1.0));
+        d.crest = static_cast<float>(moments.peak / mean);
+        d.bandwidth = static_cast<float>(upper - lower);
+        return d;
+    }
+
+  private:
+    static constexpr float kFloor = 1e-12f;  // Keeps log() finite on empty bins
+
+    // Frequency of the first bin at which the cumulative power reaches target
+    double frequencyAtCumulativePower(std::span<const float> power, double target) const {
+        double cumulative = 0.0;
+        std::size_t block = 0;
+        for (; block + 1 < mBlockPower.size() && cumulative + mBlockPower[block] < target; ++block)
+            cumulative += mBlockPower[block];
+
+        // Normally ends inside this block; carrying on covers rounding differences between the
+        // block sums and this running sum
+        for (auto k = block * kBlockSize; k < power.size(); ++k) {
+            cumulative += power[k];
+            if (cumulative >= target)
+                return mFrequencies[k] * mNyquist;
+        }
+        return mNyquist;
+    }
+
+    double mNyquist = 0.0;
+    double mRolloffFraction = 0.85;
+    double mOccupiedFraction = 0.99;
+    std::vector<double> mFrequencies;  // Bin frequency / nyquist
+    std::vector<double> mBlockPower;   // Power of each kBlockSize block of the last spectrum
+};
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Fft.h"
+#include "tb_FifoBuffer.h"
+#include "tb_Windowing.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <complex>
+#include <span>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Streaming short-time Fourier transform.
+ *
+ * Accepts blocks of any size, frames them with a FifoBuffer, windows every channel straight out of
+ * the FIFO (applyWindow) and produces the one-sided power spectrum of every channel once per hop, plus the magnitude
+ * spectrum unless Spectra::PowerOnly is chosen. All storage is allocated in the constructor, so process() is safe to
+ * call from the audio thread.
+ *
+ * Spectra (and the time-domain frame they came from) are only valid inside the frame callback
+ * passed to process(); feed them straight into applyMelFilterbank(), spectralFlux(),
+ * spectralCentroid() or rmsEnergy().
+ */
+class Stft {
+  public:
+    /**
+     * Spectra computed for every frame
+     */
+    enum class Spectra {
+        PowerAndMagnitude,  // Magnitudes kept for getMagnitudeSpectrum(channel)
+        PowerOnly           // Magnitudes only on request, through getMagnitudeSpectrum(channel, dst)
+    };
+
+    /**
+     * @param numChannels Number of audio channels (must be > 0)
+     * @param frameSize Analysis frame size in samples (power of two, >= 4)
+     * @param hopSize Number of samples between consecutive frames (must be in [1, frameSize])
+     * @param windowType Analysis window applied to every frame
+     * @param windowSymmetry Symmetric or periodic analysis window
+     * @param spectra Whether to keep a magnitude spectrum per frame. Use PowerOnly when the
+     *                magnitudes are written straight into their consumer (e.g.
+     *                SpectralFluxTracker::getNextFrame()), so they are computed exactly once
+     */
+    Stft(int numChannels, int frameSize, int hopSize, WindowType windowType = WindowType::Hann,
+         WindowSymmetry windowSymmetry = WindowSymmetry::Symmetric, Spectra spectra = Spectra::PowerAndMagnitude) :
+        mFifo(numChannels, frameSize),
+        mFft(frameSize),
+        mHopSize(hopSize),
+        mWindow(cachedWindow<float>(windowType, frameSize, windowSymmetry)),
+        mWindowed(numChannels, frameSize),
+        mSpectrum(mFft.numBins()),
+        mPower(numChannels, mFft.numBins()),
+        mMagnitude(numChannels, spectra == Spectra::PowerAndMagnitude ? mFft.numBins() : 0),
+        mSpectra(spectra) {
+        tb_throwIf(numChannels <= 0);
+        tb_throwIf(hopSize <= 0 || hopSize > frameSize);
+    }
+
+    int getNumChannels() const noexcept { return static_cast<int>(mPower.getNumChannels()); }
+    int getFrameSize() const noexcept { return mFft.size(); }
+    int getHopSize() const noexcept { return mHopSize; }
+    int getNumBins() const noexcept { return mFft.numBins(); }
+    Spectra getSpectra() const noexcept { return mSpectra; }
+
+    /**
+     * Pushes a block of audio and analyses every frame it completes.
+     *
+     * @param input Planar input with getNumChannels() channels and any number of frames
+     * @param onFrame Called as `onFrame(const Stft&)` once per completed frame. The spectra
+     *                returned by the getters are valid until the callback returns
+     * @return The number of frames analysed
+     */
+    template<typename Callback>
+    int process(choc::buffer::ChannelArrayView<float> input, Callback&& onFrame) {
+        tb_assert(static_cast<int>(input.getNumChannels()) == getNumChannels());
+
+        int numFramesAnalysed = 0;
+        auto remaining = input;
+        for (;;) {
+            remaining = mFifo.push(remaining);
+            if (! mFifo.isFull())
+                break;
+
+            analyseFrame();
+            onFrame(static_cast<const Stft&>(*this));
+            ++numFramesAnalysed;
+            mFifo.pop(mHopSize);
+        }
+
+        return numFramesAnalysed;
+    }
+
+    /**
+     * @return The one-sided power spectrum (|X|²) of the current frame, getNumBins() long
+     */
+    std::span<const float> getPowerSpectrum(int channel) const {
+        return { mPower.getChannel(channel).data.data, static_cast<size_t>(getNumBins()) };
+    }
+
+    /**
+     * @return The one-sided magnitude spectrum (|X|) of the current frame, getNumBins() long.
+     *         Only available with Spectra::PowerAndMagnitude
+     */
+    std::span<const float> getMagnitudeSpectrum(int channel) const {
+        tb_assert(mSpectra == Spectra::PowerAndMagnitude);
+        return { mMagnitude.getChannel(channel).data.data, static_cast<size_t>(getNumBins()) };
+    }
+
+    /**
+     * Writes the one-sided magnitude spectrum (|X|) of the current frame into dst, e.g.
+     * SpectralFluxTracker::getNextFrame(). With Spectra::PowerOnly this is where the magnitudes
+     * are computed, straight into dst; otherwise the ones already kept are copied
+     *
+     * @param dst Output with getNumBins() elements
+     */
+    void getMagnitudeSpectrum(int channel, std::span<float> dst) const {
+        tb_assert(dst.size() == static_cast<size_t>(getNumBins()));
+        if (mSpectra == Spectra::PowerAndMagnitude) {
+            const auto magnitude = getMagnitudeSpectrum(channel);
+            std::copy(magnitude.begin(), magnitude.end(), dst.begin());
+        } else {
+            magnitudeFromPower(channel, dst);
+        }
+    }
+
+    /**
+     * @return The un-windowed time-domain samples of the current frame, getFrameSize() long
+     */
+    std::span<const float> getFrame(int channel) const {
+        return { mFifo.getBuffer().getChannel(channel).data.data, static_cast<size_t>(getFrameSize()) };
+    }
+
+    /**
+     * Discards any partially filled frame
+     */
+    void reset() { mFifo.clear(); }
+
+  private:
+    void analyseFrame() {
+        applyWindow(mFifo.getBuffer(), mWindow, mWindowed.getView());
+
+        for (int ch = 0; ch < getNumChannels(); ++ch) {
+            const std::span<const float> windowed(mWindowed.getChannel(ch).data.data, mWindow.size());
+            mFft.powerSpectrum(windowed, mSpectrum, { mPower.getChannel(ch).data.data, mSpectrum.size() });
+            if (mSpectra == Spectra::PowerAndMagnitude)
+                magnitudeFromPower(ch, { mMagnitude.getChannel(ch).data.data, mSpectrum.size() });
+        }
+    }
+
+    void magnitudeFromPower(int channel, std::span<float> dst) const {
+        const auto* power = mPower.getChannel(channel).data.data;
+        for (size_t k = 0; k < dst.size(); ++k)
+            dst[k] = std::sqrt(power[k]);
+    }
+
+    FifoBuffer<float> mFifo;
+    Fft mFft;
+    int mHopSize = 0;
+    std::span<const float> mWindow;  // Shared, see cachedWindow()
+    choc::buffer::ChannelArrayBuffer<float> mWindowed;  // FFT input
+    std::vector<std::complex<float>> mSpectrum;
+    choc::buffer::ChannelArrayBuffer<float> mPower;
+    choc::buffer::ChannelArrayBuffer<float> mMagnitude;  // Empty with Spectra::PowerOnly
+    Spectra mSpectra;
+
+  public:
+    Stft(const Stft&) = delete;
+    Stft& operator=(const Stft&) = delete;
+};
+
+}
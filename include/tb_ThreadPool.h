@@ -0,0 +1,182 @@
+#pragma once
+
+#include "tb_Core.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tb {
+
+/**
+ * A fixed set of persistent worker threads for fork/join style parallel loops.
+ *
+ * parallelFor() hands out task indices from a shared atomic counter, so idle threads keep
+ * pulling work until none is left, and the calling thread takes part too. Running a loop never
+ * creates threads and never allocates (unless a task throws).
+ */
+class ThreadPool {
+  public:
+    /**
+     * @param numThreads Total number of threads running each parallelFor(), including the
+     *                   calling thread (must be > 0; 1 runs everything on the caller)
+     */
+    explicit ThreadPool(int numThreads) {
+        tb_throwIf(numThreads <= 0);
+
+        mWorkers.reserve(numThreads - 1);
+        for (int i = 1; i < numThreads; ++i)
+            mWorkers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mMutex);
+            mQuit = true;
+        }
+        mWake.notify_all();
+        for (auto& worker : mWorkers)
+            worker.join();
+    }
+
+    /**
+     * @return The number of threads that run a parallelFor(), including the caller
+     */
+    int getNumThreads() const noexcept { return static_cast<int>(mWorkers.size()) + 1; }
+
+    /**
+     * Calls `fn(taskIndex)` for every index in [0, numTasks), spread over all threads, and
+     * returns once every call has finished. If any call throws, the first exception is
+     * rethrown here after the remaining tasks have run.
+     *
+     * Only one loop runs at a time; concurrent callers are serialised. A parallelFor() issued
+     * from inside one of this pool's tasks runs inline on the calling thread, since every
+     * thread is already busy with the outer loop.
+     */
+    template<typename Fn>
+    void parallelFor(int numTasks, Fn&& fn) {
+        if (numTasks <= 0)
+            return;
+
+        if (mWorkers.empty() || numTasks == 1 || tRunningPool == this) {
+            for (int i = 0; i < numTasks; ++i)
+                fn(i);
+            return;
+        }
+
+        using Callable = std::remove_reference_t<Fn>;
+        std::lock_guard runLock(mRunMutex);
+        {
+            std::unique_lock lock(mMutex);
+            mIdle.wait(lock, [this] { return mActiveWorkers == 0; });
+
+            mJob = { .invoke = [](void* context, int index) { (*static_cast<Callable*>(context))(index); },
+                     .context = const_cast<void*>(static_cast<const void*>(&fn)),
+                     .numTasks = numTasks };
+            mNextTask.store(0, std::memory_order_relaxed);
+            mPendingTasks.store(numTasks, std::memory_order_relaxed);
+            mError = nullptr;
+            ++mGeneration;
+        }
+        mWake.notify_all();
+
+        {
+            const auto* outerPool = std::exchange(tRunningPool, this);
+            runTasks(mJob);
+            tRunningPool = outerPool;
+        }
+
+        std::unique_lock lock(mMutex);
+        mIdle.wait(lock, [this] {
+            return mPendingTasks.load(std::memory_order_acquire) == 0 && mActiveWorkers == 0;
+        });
+
+        if (mError)
+            std::rethrow_exception(std::exchange(mError, nullptr));
+    }
+
+  private:
+    struct Job {
+        void (*invoke)(void*, int) = nullptr;
+        void* context = nullptr;
+        int numTasks = 0;
+    };
+
+    void runTasks(const Job& job) {
+        for (;;) {
+            const auto index = mNextTask.fetch_add(1, std::memory_order_relaxed);
+            if (index >= job.numTasks)
+                return;
+
+            try {
+                job.invoke(job.context, index);
+            } catch (...) {
+                std::lock_guard lock(mMutex);
+                if (! mError)
+                    mError = std::current_exception();
+            }
+
+            if (mPendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard lock(mMutex);
+                mIdle.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        tRunningPool = this;
+        uint64_t seenGeneration = 0;
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock lock(mMutex);
+                mWake.wait(lock, [&] { return mQuit || mGeneration != seenGeneration; });
+                if (mQuit)
+                    return;
+
+                seenGeneration = mGeneration;
+                job = mJob;
+                ++mActiveWorkers;
+            }
+
+            runTasks(job);
+
+            {
+                std::lock_guard lock(mMutex);
+                --mActiveWorkers;
+            }
+            mIdle.notify_all();
+        }
+    }
+
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mRunMutex;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mIdle;
+
+    Job mJob;
+    uint64_t mGeneration = 0;
+    int mActiveWorkers = 0;
+    bool mQuit = false;
+    std::exception_ptr mError;
+
+    std::atomic<int> mNextTask { 0 };
+    std::atomic<int> mPendingTasks { 0 };
+
+    // The pool whose tasks the current thread is running, to detect nested parallelFor() calls
+    static inline thread_local const ThreadPool* tRunningPool = nullptr;
+
+  public:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+};
+
+}
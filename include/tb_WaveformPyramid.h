@@ -0,0 +1,269 @@
+#pragma once
+
+#include "tb_Core.h"
+#include "tb_Space.h"
+
+#include <algorithm>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace tb {
+
+/**
+ * Peak and RMS level of a stretch of audio, e.g. one pixel column of a waveform display
+ */
+struct WaveformSummary {
+    float min = 0.f;
+    float max = 0.f;
+    float rms = 0.f;
+};
+
+enum class WaveformValue {
+    Min,
+    Max,
+    Rms
+};
+
+/**
+ * Multi-resolution min/max/RMS summary of a recording, for drawing waveforms at any zoom level
+ * without rescanning the samples.
+ *
+ * Level 0 summarises blocks of blockSize samples, and every level above summarises fanOut buckets
+ * of the level below, up to a single bucket covering everything. append() adds samples at the
+ * end (e.g. while recording) and only updates the last bucket of each level, so building the
+ * pyramid costs O(1) amortised per sample. It takes about 4 / blockSize · fanOut / (fanOut - 1)
+ * times the memory of the audio itself (1/12 with the defaults).
+ *
+ * query() picks the coarsest level whose buckets are no wider than a pixel, so each pixel merges
+ * fewer than fanOut + 2 buckets and a whole view costs O(pixels) whatever the zoom range. Pixel
+ * edges are rounded outwards to bucket edges, so neighbouring pixels may share a bucket but a
+ * peak is never missed. Below blockSize samples per pixel the raw samples carry more detail than
+ * the pyramid; draw those instead (e.g. through catmullRom::spline).
+ *
+ * append() allocates as the levels grow, so call it off the audio thread (e.g. from the thread
+ * draining a recording FifoBuffer), or reserve() up front. The class is not synchronised.
+ */
+class WaveformPyramid {
+  public:
+    /**
+     * @param numChannels Number of audio channels (must be > 0)
+     * @param blockSize Samples per level 0 bucket (must be > 0)
+     * @param fanOut Buckets merged into each bucket of the next level (must be >= 2)
+     */
+    WaveformPyramid(int numChannels, int blockSize = 64, int fanOut = 4) {
+        tb_throwIf(numChannels <= 0);
+        tb_throwIf(blockSize <= 0);
+        tb_throwIf(fanOut < 2);
+
+        mBlockSize = static_cast<std::size_t>(blockSize);
+        mFanOut = static_cast<std::size_t>(fanOut);
+        mLevels.assign(static_cast<std::size_t>(numChannels), std::vector<std::vector<Bucket>>(1));
+    }
+
+    /**
+     * Appends samples to the end of every channel
+     */
+    void append(choc::buffer::ChannelArrayView<float> input) {
+        tb_assert(static_cast<int>(input.getNumChannels()) == getNumChannels());
+
+        const auto numFrames = static_cast<std::size_t>(input.getNumFrames());
+        if (numFrames == 0)
+            return;
+
+        const auto firstDirty = mNumSamples / mBlockSize;
+        for (std::size_t ch = 0; ch < mLevels.size(); ++ch) {
+            const auto* in = input.getChannel(static_cast<choc::buffer::ChannelCount>(ch)).data.data;
+            auto& level0 = mLevels[ch][0];
+
+            // One run per level 0 bucket the new samples touch
+            for (std::size_t i = 0; i < numFrames;) {
+                const auto position = mNumSamples + i;
+                if (position / mBlockSize == level0.size())
+                    level0.emplace_back();
+
+                const auto runLength = std::min(mBlockSize - position % mBlockSize, numFrames - i);
+                level0.back().merge(scan(in + i, runLength));
+                i += runLength;
+            }
+        }
+        mNumSamples += numFrames;
+
+        for (auto& levels : mLevels)
+            propagate(levels, firstDirty);
+    }
+
+    /**
+     * Reserves memory for numSamples samples per channel, so append() does not allocate until
+     * the recording grows past it
+     */
+    void reserve(std::size_t numSamples) {
+        for (auto& levels : mLevels) {
+            auto buckets = (numSamples + mBlockSize - 1) / mBlockSize;
+            for (std::size_t level = 0; buckets > 0; ++level) {
+                if (level == levels.size())
+                    levels.emplace_back();
+                levels[level].reserve(buckets);
+                if (buckets == 1)
+                    break;
+                buckets = (buckets + mFanOut - 1) / mFanOut;
+            }
+        }
+    }
+
+    /**
+     * Forgets all samples, keeping the allocated memory
+     */
+    void clear() {
+        for (auto& levels : mLevels)
+            for (auto& level : levels)
+                level.clear();
+        mNumSamples = 0;
+    }
+
+    /**
+     * Summarises samples [startSample, endSample) of a channel into pixels.size() equal columns
+     *
+     * @param channel Channel to read
+     * @param startSample First sample of the view (fractional for smooth scrolling)
+     * @param endSample End of the view; columns past the end of the recording are left at zero
+     * @param pixels One summary per pixel column
+     */
+    void query(int channel, double startSample, double endSample, std::span<WaveformSummary> pixels) const {
+        tb_assert(channel >= 0 && channel < getNumChannels());
+        tb_assert(endSample >= startSample);
+        if (pixels.empty())
+            return;
+
+        const auto& levels = mLevels[static_cast<std::size_t>(channel)];
+        const auto samplesPerPixel = (endSample - startSample) / static_cast<double>(pixels.size());
+
+        std::size_t level = 0;
+        while (level + 1 < levels.size() && ! levels[level + 1].empty() &&
+               static_cast<double>(getBucketSize(static_cast<int>(level) + 1)) <= samplesPerPixel)
+            ++level;
+
+        const auto& buckets = levels[level];
+        const auto bucketSize = static_cast<double>(getBucketSize(static_cast<int>(level)));
+        const auto numSamples = static_cast<double>(mNumSamples);
+
+        for (std::size_t p = 0; p < pixels.size(); ++p) {
+            const auto from = std::max(startSample + samplesPerPixel * static_cast<double>(p), 0.0);
+            const auto to = std::min(startSample + samplesPerPixel * static_cast<double>(p + 1), numSamples);
+            if (to <= from) {
+                pixels[p] = {};
+                continue;
+            }
+
+            const auto first = static_cast<std::size_t>(from / bucketSize);
+            const auto last = std::min(static_cast<std::size_t>(std::ceil(to / bucketSize)), buckets.size());
+
+            Bucket merged;
+            for (auto b = first; b < last; ++b)
+                merged.merge(buckets[b]);
+
+            const auto covered = std::min(static_cast<double>(last) * bucketSize, numSamples) -
+                                 static_cast<double>(first) * bucketSize;
+            pixels[p] = { merged.min, merged.max, static_cast<float>(std::sqrt(merged.sumOfSquares / covered)) };
+        }
+    }
+
+    std::size_t getNumSamples() const noexcept { return mNumSamples; }
+    int getNumChannels() const noexcept { return static_cast<int>(mLevels.size()); }
+    int getNumLevels() const noexcept {
+        const auto& levels = mLevels.front();
+        return static_cast<int>(std::count_if(levels.begin(), levels.end(), [](const auto& l) { return ! l.empty(); }));
+    }
+
+    /**
+     * @return The number of samples each bucket of a level summarises
+     */
+    std::size_t getBucketSize(int level) const {
+        auto size = mBlockSize;
+        for (int i = 0; i < level; ++i)
+            size *= mFanOut;
+        return size;
+    }
+
+  private:
+    struct Bucket {
+        float min = std::numeric_limits<float>::max();
+        float max = std::numeric_limits<float>::lowest();
+        double sumOfSquares = 0.0;
+
+        void merge(const Bucket& other) {
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+            sumOfSquares += other.sumOfSquares;
+        }
+    };
+
+    static Bucket scan(const float* samples, std::size_t numSamples) {
+        Bucket bucket;
+        for (std::size_t i = 0; i < numSamples; ++i) {
+            bucket.min = std::min(bucket.min, samples[i]);
+            bucket.max = std::max(bucket.max, samples[i]);
+            bucket.sumOfSquares += static_cast<double>(samples[i]) * samples[i];
+        }
+        return bucket;
+    }
+
+    // Rebuilds the buckets above level 0 that cover level 0 buckets firstDirty onwards
+    void propagate(std::vector<std::vector<Bucket>>& levels, std::size_t firstDirty) const {
+        for (std::size_t level = 1; levels[level - 1].size() > 1; ++level) {
+            if (level == levels.size())
+                levels.emplace_back();
+
+            const auto& children = levels[level - 1];
+            auto& parents = levels[level];
+            firstDirty /= mFanOut;
+            parents.resize((children.size() + mFanOut - 1) / mFanOut);
+
+            for (auto p = firstDirty; p < parents.size(); ++p) {
+                Bucket merged;
+                const auto end = std::min((p + 1) * mFanOut, children.size());
+                for (auto c = p * mFanOut; c < end; ++c)
+                    merged.merge(children[c]);
+                parents[p] = merged;
+            }
+        }
+    }
+
+    std::size_t mBlockSize = 64;
+    std::size_t mFanOut = 4;
+    std::vector<std::vector<std::vector<Bucket>>> mLevels;  // [channel][level][bucket]
+    std::size_t mNumSamples = 0;
+};
+
+/**
+ * Turns one value of a run of summaries into a polyline, e.g. the upper (Max) and lower (Min)
+ * outline of a waveform, ready for catmullRom::spline or drawing
+ *
+ * @param points One point per summary, as structure-of-arrays (e.g. a PointBuffer); point i is at
+ *               x = xStart + i · xStep
+ */
+inline void toPoints(std::span<const WaveformSummary> summaries, WaveformValue value, float xStart, float xStep,
+                     PointSpan points) {
+    tb_assert(points.size() == summaries.size());
+
+    for (std::size_t i = 0; i < summaries.size(); ++i) {
+        const auto& s = summaries[i];
+        points.x[i] = xStart + static_cast<float>(i) * xStep;
+        points.y[i] = value == WaveformValue::Min ? s.min : value == WaveformValue::Max ? s.max : s.rms;
+    }
+}
+
+inline void toPoints(std::span<const WaveformSummary> summaries, WaveformValue value, float xStart, float xStep,
+                     std::span<Point> points) {
+    tb_assert(points.size() == summaries.size());
+
+    for (std::size_t i = 0; i < summaries.size(); ++i) {
+        const auto& s = summaries[i];
+        const auto y = value == WaveformValue::Min ? s.min : value == WaveformValue::Max ? s.max : s.rms;
+        points[i] = Point(xStart + static_cast<float>(i) * xStep, y);
+    }
+}
+
+}
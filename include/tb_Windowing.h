@@ -1,11 +1,21 @@
-
 #pragma once
 
 #include "tb_Core.h"
+#include "tb_Simd.h"
 
+#include <array>
+#include <choc_SampleBuffers.h>
 #include <cmath>
-#include <vector>
+#include <concepts>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numbers>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace tb {
 
@@ -15,34 +25,165 @@ enum class WindowType {
     Hamming
 };
 
-template <std::floating_point T>
-std::vector<T> window(WindowType windowType, int size) {
+/**
+ * Symmetric windows (the default) are for filter design and stand-alone use. Periodic windows
+ * leave out the final, repeated sample, so overlapping frames add up evenly; that is usually
+ * what STFT analysis/resynthesis wants.
+ */
+enum class WindowSymmetry {
+    Symmetric,
+    Periodic
+};
+
+namespace detail {
+
+// cos() usable in constant expressions: reduce to [0, pi/2], then a Taylor series that is
+// accurate to double precision on that interval
+constexpr double constexprCos(double x) {
     constexpr auto pi = std::numbers::pi;
+    constexpr auto twoPi = 2.0 * pi;
 
-    std::vector<T> window(size, 0);
+    const auto turns = static_cast<long long>(x / twoPi);
+    x -= static_cast<double>(turns) * twoPi;
+    if (x < 0.0)
+        x = -x;
+    if (x > pi)
+        x = twoPi - x;
 
-    if (windowType == WindowType::Hann) {
-        for (size_t i = 0; i < window.size(); ++i)
-            window[i] = static_cast<T>(0.5 - std::cos((2.0 * i * pi) / (window.size() - 1)) / 2);
-    } else if (windowType == WindowType::BlackmanHarris) {
+    double sign = 1.0;
+    if (x > pi / 2.0) {
+        x = pi - x;
+        sign = -1.0;
+    }
+
+    const auto x2 = x * x;
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k <= 12; ++k) {
+        term *= -x2 / ((2.0 * k - 1.0) * (2.0 * k));
+        sum += term;
+    }
+    return sign * sum;
+}
+
+template<std::floating_point T, typename Cos>
+constexpr T windowSample(WindowType windowType, WindowSymmetry symmetry, std::size_t i, std::size_t size, Cos cos) {
+    constexpr auto pi = std::numbers::pi;
+    const auto period = symmetry == WindowSymmetry::Periodic ? size : size - 1;
+
+    switch (windowType) {
+    case WindowType::Hann:
+        return static_cast<T>(0.5 - cos((2.0 * i * pi) / period) / 2);
+    case WindowType::BlackmanHarris: {
         constexpr T a0 = 0.35875;
         constexpr T a1 = 0.48829;
         constexpr T a2 = 0.14128;
         constexpr T a3 = 0.01168;
 
-        for (size_t i = 0; i < window.size(); ++i) {
-            const auto x = i / static_cast<double>(window.size() - 1);
-            window[i] = static_cast<T>(a0 - a1 * std::cos(2.0 * pi * x) + a2 * std::cos(4.0 * pi * x) -
-                        a3 * std::cos(6.0 * pi * x));
-        }
-    } else if (windowType == WindowType::Hamming) {
-        for (size_t i = 0; i < window.size(); ++i)
-            window[i] = static_cast<T>(0.54 - 0.46 * std::cos((2.0 * i * pi) / (window.size() - 1)));
-    } else {
-        tb_assert(false);
+        const auto x = i / static_cast<double>(period);
+        return static_cast<T>(a0 - a1 * cos(2.0 * pi * x) + a2 * cos(4.0 * pi * x) - a3 * cos(6.0 * pi * x));
     }
+    case WindowType::Hamming:
+        return static_cast<T>(0.54 - 0.46 * cos((2.0 * i * pi) / period));
+    }
+
+    tb_assert(false);
+    return 0;
+}
+
+}
+
+template <std::floating_point T>
+std::vector<T> window(WindowType windowType, int size, WindowSymmetry symmetry = WindowSymmetry::Symmetric) {
+    std::vector<T> window(size, 0);
+    for (size_t i = 0; i < window.size(); ++i)
+        window[i] = detail::windowSample<T>(windowType, symmetry, i, window.size(),
+                                            [](double x) { return std::cos(x); });
+
+    return window;
+}
+
+/**
+ * Compile-time window table, e.g. `constexpr auto hann = window<float, WindowType::Hann, 1024>();`
+ *
+ * Matches window<T>(Type, N, Symmetry) to within a few ulp (the cosine is evaluated by a series
+ * rather than std::cos). Large tables may need a higher constexpr step limit on some compilers.
+ */
+template<std::floating_point T, WindowType Type, std::size_t N, WindowSymmetry Symmetry = WindowSymmetry::Symmetric>
+constexpr std::array<T, N> window() {
+    static_assert(N >= 2);
+
+    std::array<T, N> window {};
+    for (std::size_t i = 0; i < N; ++i)
+        window[i] = detail::windowSample<T>(Type, Symmetry, i, N, detail::constexprCos);
 
     return window;
 }
 
-}
\ No newline at end of file
+/**
+ * Process-wide shared copy of window<T>(windowType, size, symmetry).
+ *
+ * The table for each (type, size, symmetry, T) is computed on first request and then kept for the
+ * lifetime of the program, so the returned span never dangles and every caller shares the same
+ * read-only data. Thread-safe: tables are built outside the lock, so a first build never blocks
+ * lookups of other tables, but the lookup itself still locks, so call this at construction time
+ * rather than on the audio thread.
+ */
+template<std::floating_point T>
+std::span<const T> cachedWindow(WindowType windowType, int size,
+                               WindowSymmetry symmetry = WindowSymmetry::Symmetric) {
+    static std::mutex mutex;
+    static std::map<std::tuple<WindowType, int, WindowSymmetry>, std::unique_ptr<const std::vector<T>>> cache;
+
+    const auto key = std::make_tuple(windowType, size, symmetry);
+    {
+        std::lock_guard lock(mutex);
+        if (const auto it = cache.find(key); it != cache.end())
+            return *it->second;
+    }
+
+    // Threads racing on the same key build identical tables; the first one inserted is kept
+    auto table = std::make_unique<const std::vector<T>>(window<T>(windowType, size, symmetry));
+    std::lock_guard lock(mutex);
+    return *cache.try_emplace(key, std::move(table)).first->second;
+}
+
+/**
+ * Writes source × window into destination (which may be source itself)
+ */
+template<std::floating_point T>
+void applyWindow(std::span<const T> source, std::span<const T> window, std::span<T> destination) {
+    tb_assert(source.size() == window.size() && destination.size() == window.size());
+
+    if constexpr (std::same_as<T, float>) {
+        simd::multiply(source, window, destination);
+    } else {
+        for (size_t i = 0; i < window.size(); ++i)
+            destination[i] = source[i] * window[i];
+    }
+}
+
+/**
+ * Writes source × window into destination for every channel in a single pass, e.g. straight from
+ * a FifoBuffer into FFT scratch memory without an intermediate copy
+ */
+template<std::floating_point T>
+void applyWindow(choc::buffer::ChannelArrayView<T> source, std::span<const T> window,
+                 choc::buffer::ChannelArrayView<T> destination) {
+    tb_assert(source.getNumChannels() == destination.getNumChannels());
+    tb_assert(source.getNumFrames() == window.size() && destination.getNumFrames() == window.size());
+
+    for (choc::buffer::ChannelCount ch = 0; ch < source.getNumChannels(); ++ch)
+        applyWindow(std::span<const T>(source.getChannel(ch).data.data, window.size()), window,
+                    std::span<T>(destination.getChannel(ch).data.data, window.size()));
+}
+
+/**
+ * Multiplies every channel of buffer by window, in place
+ */
+template<std::floating_point T>
+void applyWindow(choc::buffer::ChannelArrayView<T> buffer, std::span<const T> window) {
+    applyWindow(buffer, window, buffer);
+}
+
+}
@@ -1,4 +1,5 @@
 #include "tb_AudioFeatures.h"
+#include "tb_Math.h"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 
@@ -74,3 +75,266 @@ TEST_CASE("spectralCentroid - single bin spectrum (DC only)", "[spectralCentroid
     // If this is considered valid input, the function should guard against it.
     WARN("Single-bin input exposes division by zero in freqResolution calculation");
 }
+
+TEST_CASE("SparseMelFilterbank - matches dense filterbank output", "[melFilterbank]") {
+    const std::size_t nMelBins = 40;
+    const std::size_t nFftBins = 513;
+    const double sampleRate = 44100.0;
+
+    const auto dense  = tb::melFilterbank(nMelBins, nFftBins, sampleRate);
+    const auto sparse = tb::sparseMelFilterbank(nMelBins, nFftBins, sampleRate);
+
+    REQUIRE(sparse.numMelBins() == nMelBins);
+    REQUIRE(sparse.numFftBins == nFftBins);
+    REQUIRE(sparse.weights.size() < nMelBins * nFftBins / 10);
+
+    std::vector<float> power(nFftBins);
+    for (std::size_t k = 0; k < power.size(); ++k)
+        power[k] = 0.5f + 0.5f * std::sin(0.37f * static_cast<float>(k));
+
+    std::vector<float> denseOut(nMelBins);
+    std::vector<float> sparseOut(nMelBins);
+    tb::applyMelFilterbank(power, dense, denseOut);
+    tb::applyMelFilterbank(power, sparse, sparseOut);
+
+    for (std::size_t m = 0; m < nMelBins; ++m)
+        REQUIRE_THAT(sparseOut[m], WithinAbs(denseOut[m], 1e-6f));
+}
+
+TEST_CASE("SparseMelFilterbank - bands cover exactly the non-zero weights", "[melFilterbank]") {
+    const auto dense  = tb::melFilterbank(26, 257, 16000.0);
+    const auto sparse = tb::makeSparse(dense);
+
+    for (std::size_t m = 0; m < dense.size(); ++m) {
+        const auto& band = sparse.bands[m];
+        const auto weights = sparse.bandWeights(m);
+        for (std::size_t k = 0; k < dense[m].size(); ++k) {
+            const bool inBand = k >= band.startBin && k < band.startBin + band.length;
+            if (inBand)
+                REQUIRE(weights[k - band.startBin] == dense[m][k]);
+            else
+                REQUIRE(dense[m][k] == 0.f);
+        }
+    }
+}
+
+TEST_CASE("melFilterbank - frequency scales and Slaney normalisation", "[melFilterbank]") {
+    using tb::FrequencyScale;
+
+    for (const auto scale : { FrequencyScale::MelHtk, FrequencyScale::MelSlaney, FrequencyScale::Bark,
+                              FrequencyScale::Erb }) {
+        for (const double hz : { 0.0, 150.0, 999.0, 1000.0, 4321.0, 20000.0 })
+            REQUIRE_THAT(tb::detail::scaleToHz(scale, tb::detail::hzToScale(scale, hz)), WithinAbs(hz, 1e-6));
+    }
+
+    // Slaney mel: 1 kHz is 15 mel, and 200/3 Hz per mel below it
+    REQUIRE_THAT(tb::detail::hzToScale(FrequencyScale::MelSlaney, 1000.0), WithinAbs(15.0, 1e-12));
+    REQUIRE_THAT(tb::detail::hzToScale(FrequencyScale::MelSlaney, 200.0), WithinAbs(3.0, 1e-12));
+
+    // The default settings reproduce the original HTK filterbank exactly
+    const auto htk = tb::melFilterbank(40, 513, 44100.0);
+    REQUIRE(tb::melFilterbank(tb::FilterbankSettings { .nMelBins = 40, .nFftBins = 513, .sampleRate = 44100.0 }) == htk);
+
+    // Area normalisation: every triangle integrates (over Hz) to ~1, whatever its width
+    const tb::FilterbankSettings settings { .nMelBins = 40,
+                                            .nFftBins = 4097,
+                                            .sampleRate = 44100.0,
+                                            .fMin = 100.0,
+                                            .scale = FrequencyScale::MelSlaney,
+                                            .norm = tb::FilterbankNorm::Slaney };
+    const auto binHz = 22050.0 / 4096.0;
+    for (const auto& band : tb::melFilterbank(settings)) {
+        double area = 0.0;
+        for (const auto w : band)
+            area += w * binHz;
+        REQUIRE_THAT(area, WithinAbs(1.0, 0.02));
+    }
+}
+
+TEST_CASE("cachedMelFilterbank - shares one table per settings value", "[melFilterbank]") {
+    const tb::FilterbankSettings erb { .nMelBins = 32, .nFftBins = 1025, .scale = tb::FrequencyScale::Erb };
+    auto bark = erb;
+    bark.scale = tb::FrequencyScale::Bark;
+
+    const auto& a = tb::cachedMelFilterbank(erb);
+    const auto& b = tb::cachedMelFilterbank(erb);
+    const auto& c = tb::cachedMelFilterbank(bark);
+
+    REQUIRE(&a == &b);
+    REQUIRE(&a != &c);
+    REQUIRE(a.weights == tb::sparseMelFilterbank(erb).weights);
+    REQUIRE(c.weights != a.weights);
+}
+
+TEST_CASE("simd kernels - every supported ISA matches a double reference", "[simd]") {
+    const std::size_t n = 1003;  // Not a multiple of any lane width or block size
+    std::vector<float> a(n), b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = std::sin(0.01f * static_cast<float>(i)) + 1.1f;
+        b[i] = std::cos(0.013f * static_cast<float>(i)) + 1.2f;
+    }
+
+    std::vector<double> x(n);
+    double dot = 0.0, flux = 0.0, sum = 0.0, weighted = 0.0, sumX4 = 0.0, sumLog2 = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<double>(i) / static_cast<double>(n - 1);
+        dot += static_cast<double>(a[i]) * b[i];
+        flux += std::max(static_cast<double>(b[i]) - a[i], 0.0);
+        sum += a[i];
+        weighted += static_cast<double>(i) * a[i];
+        sumX4 += x[i] * x[i] * x[i] * x[i] * a[i];
+        sumLog2 += std::log2(a[i]);
+    }
+
+    const auto defaultIsa = tb::simd::getIsa();
+    for (auto isa : { tb::simd::Isa::Portable, tb::simd::Isa::Sse2, tb::simd::Isa::Avx2,
+                      tb::simd::Isa::Avx512 }) {
+        if (! tb::simd::isSupported(isa))
+            continue;
+
+        REQUIRE(tb::simd::setIsa(isa) == isa);
+        REQUIRE_THAT(tb::simd::dot(a, b), WithinRel(dot, 1e-5));
+        REQUIRE_THAT(tb::simd::positiveDifferenceSum(a, b), WithinRel(flux, 1e-5));
+
+        const auto moments = tb::simd::indexMoments(a);
+        REQUIRE_THAT(moments.sum, WithinRel(sum, 1e-5));
+        REQUIRE_THAT(moments.indexWeightedSum, WithinRel(weighted, 1e-5));
+
+        std::vector<float> product(n);
+        tb::simd::multiply(a, b, product);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE(product[i] == a[i] * b[i]);
+
+        std::vector<float> logs(n);
+        tb::simd::scaledLog2(a, logs, 1e-9f, 2.f);
+        for (std::size_t i = 0; i < n; ++i)
+            REQUIRE_THAT(logs[i], WithinAbs(2.0 * std::log2(a[i]), 1e-5));
+
+        const auto power = tb::simd::powerMoments(a, x, 1e-9f);
+        REQUIRE_THAT(power.sum, WithinRel(sum, 1e-12));
+        REQUIRE_THAT(power.sumX4, WithinRel(sumX4, 1e-12));
+        REQUIRE_THAT(power.sumLog2, WithinAbs(sumLog2, 1e-5 * static_cast<double>(n)));
+        REQUIRE(power.peak == *std::max_element(a.begin(), a.end()));
+    }
+    tb::simd::setIsa(defaultIsa);
+}
+
+TEST_CASE("rmsEnergy and spectralFlux - known values", "[rmsEnergy][spectralFlux]") {
+    std::vector<float> samples(1000, 0.5f);
+    REQUIRE_THAT(tb::rmsEnergy(samples), WithinRel(0.5f, 1e-6f));
+
+    std::vector<float> prev = { 1.f, 2.f, 3.f, 4.f };
+    std::vector<float> curr = { 2.f, 1.f, 5.f, 4.f };
+    REQUIRE_THAT(tb::spectralFlux(prev, curr), WithinRel(3.f, 1e-6f));
+}
+
+TEST_CASE("Batched features - match the single-frame functions", "[batch]") {
+    const std::size_t nFrames = 37;
+    const std::size_t nBins = 257;
+    const std::size_t nMelBins = 24;
+    const double sampleRate = 16000.0;
+
+    std::vector<float> spectrogram(nFrames * nBins);
+    for (std::size_t i = 0; i < spectrogram.size(); ++i)
+        spectrogram[i] = 1.f + std::sin(0.11f * static_cast<float>(i));
+
+    auto frame = [&](std::size_t f) { return std::span<const float>(spectrogram).subspan(f * nBins, nBins); };
+
+    const auto fb = tb::sparseMelFilterbank(nMelBins, nBins, sampleRate);
+    std::vector<float> mel(nFrames * nMelBins);
+    tb::applyMelFilterbankBatch(spectrogram, fb, mel);
+
+    std::vector<float> flux(nFrames), centroid(nFrames), rms(nFrames);
+    tb::spectralFluxBatch(spectrogram, nBins, flux);
+    tb::spectralCentroidBatch(spectrogram, nBins, sampleRate, centroid);
+    tb::rmsEnergyBatch(spectrogram, nBins, rms);
+
+    REQUIRE(flux[0] == 0.f);
+    std::vector<float> melFrame(nMelBins);
+    for (std::size_t f = 0; f < nFrames; ++f) {
+        tb::applyMelFilterbank(frame(f), fb, melFrame);
+        for (std::size_t m = 0; m < nMelBins; ++m)
+            REQUIRE(mel[f * nMelBins + m] == melFrame[m]);
+
+        if (f > 0)
+            REQUIRE(flux[f] == tb::spectralFlux(frame(f - 1), frame(f)));
+        REQUIRE(centroid[f] == tb::spectralCentroid(frame(f), sampleRate));
+        REQUIRE(rms[f] == tb::rmsEnergy(frame(f)));
+    }
+}
+
+TEST_CASE("fastLog2 and fastExp2 - accuracy over the float range", "[logCompress]") {
+    // Plus the float rounding of the result, which dominates far from 0
+    for (float x = 1e-30f; x < 1e30f; x *= 1.0137f) {
+        const auto log2 = std::log2(static_cast<double>(x));
+        const auto ln = std::log(static_cast<double>(x));
+        REQUIRE_THAT(tb::fastLog2(x), WithinAbs(log2, 5e-6 + std::abs(log2) * 1.2e-7));
+        REQUIRE_THAT(tb::fastLog(x), WithinAbs(ln, 5e-6 + std::abs(ln) * 2.4e-7));
+    }
+
+    for (float x = -100.f; x < 100.f; x += 0.0731f)
+        REQUIRE_THAT(tb::fastExp2(x), WithinRel(std::exp2(static_cast<double>(x)), 4e-6));
+    REQUIRE(tb::fastExp2(0.f) == 1.f);
+    REQUIRE(tb::fastExp2(10.f) == 1024.f);
+    REQUIRE(tb::fastExp2(-3.f) == 0.125f);
+
+    // Clamped to the normal float range
+    REQUIRE(tb::fastExp2(-126.f) == std::numeric_limits<float>::min());
+    REQUIRE(tb::fastExp2(-1000.f) == std::numeric_limits<float>::min());
+    REQUIRE(std::isfinite(tb::fastExp2(128.f)));
+    REQUIRE(tb::fastExp2(1000.f) == tb::fastExp2(128.f));
+    REQUIRE_THAT(tb::fastExp2(128.f), WithinRel(std::ldexp(1.0, 128), 1e-5));
+    REQUIRE_THAT(tb::fastExp(1.f), WithinRel(std::numbers::e, 1e-5));
+}
+
+TEST_CASE("logCompress - scales, accuracy modes and floor", "[logCompress]") {
+    std::vector<float> energies { 0.f, -1.f, 1e-12f, 1e-3f, 0.5f, 1.f, 2.f, 123.f, 4e7f };
+    std::vector<float> exact(energies.size()), fast(energies.size());
+
+    const float floor = 1e-10f;
+    for (auto scale : { tb::LogScale::Natural, tb::LogScale::Log10, tb::LogScale::Decibels }) {
+        tb::logCompress(energies, exact, { scale, tb::LogAccuracy::Exact, floor });
+        tb::logCompress(energies, fast, { scale, tb::LogAccuracy::Fast, floor });
+
+        const double toScale = scale == tb::LogScale::Natural ? 1.0
+                             : scale == tb::LogScale::Log10   ? 1.0 / std::log(10.0)
+                                                              : 10.0 / std::log(10.0);
+        for (std::size_t i = 0; i < energies.size(); ++i) {
+            const auto expected = toScale * std::log(std::max(static_cast<double>(energies[i]), double { floor }));
+            REQUIRE_THAT(exact[i], WithinRel(expected, 1e-6));
+            REQUIRE_THAT(fast[i], WithinAbs(expected, 2e-5));
+        }
+        REQUIRE(exact[0] == exact[1]);
+        REQUIRE(fast[0] == fast[1]);
+    }
+
+    REQUIRE_THAT(exact.back(), WithinAbs(10.0 * std::log10(4e7), 1e-4));
+}
+
+TEST_CASE("applyMelFilterbank - LogCompression overloads", "[logCompress][batch]") {
+    const std::size_t nFrames = 21;
+    const std::size_t nBins = 513;
+    const std::size_t nMelBins = 40;
+
+    std::vector<float> spectrogram(nFrames * nBins);
+    for (std::size_t i = 0; i < spectrogram.size(); ++i)
+        spectrogram[i] = 1.f + std::sin(0.07f * static_cast<float>(i));
+
+    const auto& fb = tb::cachedMelFilterbank({ .nMelBins = nMelBins, .nFftBins = nBins, .sampleRate = 22050.0 });
+    const tb::LogCompression dB { tb::LogScale::Decibels, tb::LogAccuracy::Fast, 1e-9f };
+
+    std::vector<float> batch(nFrames * nMelBins);
+    tb::applyMelFilterbankBatch(spectrogram, fb, batch, dB);
+
+    std::vector<float> natural(nMelBins), frame(nMelBins);
+    for (std::size_t f = 0; f < nFrames; ++f) {
+        const auto spectrum = std::span<const float>(spectrogram).subspan(f * nBins, nBins);
+        tb::applyMelFilterbank(spectrum, fb, natural);
+        tb::applyMelFilterbank(spectrum, fb, frame, dB);
+
+        for (std::size_t m = 0; m < nMelBins; ++m) {
+            REQUIRE(batch[f * nMelBins + m] == frame[m]);
+            REQUIRE_THAT(frame[m], WithinAbs(natural[m] * 10.0 / std::log(10.0), 1e-4));
+        }
+    }
+}
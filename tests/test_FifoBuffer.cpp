@@ -0,0 +1,84 @@
+#include "tb_FifoBuffer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <choc_SampleBuffers.h>
+#include <thread>
+
+TEST_CASE("SpscFifoBuffer - push and pop wrap around", "[SpscFifoBuffer]") {
+    tb::SpscFifoBuffer<float> fifo(2, 8);
+    choc::buffer::ChannelArrayBuffer<float> block(2, 5);
+
+    float next = 0.f;
+    float expected = 0.f;
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        for (uint32_t i = 0; i < block.getNumFrames(); ++i) {
+            block.getSample(0, i) = next;
+            block.getSample(1, i) = -next;
+            next += 1.f;
+        }
+
+        const auto remaining = fifo.push(block);
+        REQUIRE(remaining.getNumFrames() == 0);
+        REQUIRE(fifo.size() == 5);
+
+        const auto regions = fifo.getReadableRegions();
+        REQUIRE(regions.getNumFrames() == 5);
+        for (const auto& region : { regions.first, regions.second }) {
+            for (uint32_t i = 0; i < region.getNumFrames(); ++i) {
+                REQUIRE(region.getSample(0, i) == expected);
+                REQUIRE(region.getSample(1, i) == -expected);
+                expected += 1.f;
+            }
+        }
+
+        fifo.pop(5);
+        REQUIRE(fifo.size() == 0);
+    }
+}
+
+TEST_CASE("SpscFifoBuffer - push stops when full", "[SpscFifoBuffer]") {
+    tb::SpscFifoBuffer<float> fifo(1, 4);
+    choc::buffer::ChannelArrayBuffer<float> block(1, 6);
+
+    const auto remaining = fifo.push(block);
+    REQUIRE(remaining.getNumFrames() == 2);
+    REQUIRE(fifo.isFull());
+    REQUIRE(fifo.getWritableRegions().getNumFrames() == 0);
+
+    fifo.pop(3);
+    REQUIRE(fifo.freeSpace() == 3);
+}
+
+TEST_CASE("SpscFifoBuffer - transfers a sequence between threads", "[SpscFifoBuffer]") {
+    const int total = 100000;
+    tb::SpscFifoBuffer<float> fifo(1, 64);
+
+    std::thread producer([&] {
+        choc::buffer::ChannelArrayBuffer<float> block(1, 7);
+        int next = 0;
+        while (next < total) {
+            const auto numFrames = std::min(7, total - next);
+            for (int i = 0; i < numFrames; ++i)
+                block.getSample(0, i) = static_cast<float>(next + i);
+
+            auto remaining = block.getStart(numFrames);
+            while (remaining.getNumFrames() > 0)
+                remaining = fifo.push(remaining);
+            next += numFrames;
+        }
+    });
+
+    int received = 0;
+    bool inOrder = true;
+    while (received < total) {
+        const auto regions = fifo.getReadableRegions();
+        for (const auto& region : { regions.first, regions.second }) {
+            for (uint32_t i = 0; i < region.getNumFrames(); ++i)
+                inOrder = inOrder && region.getSample(0, i) == static_cast<float>(received++);
+        }
+        fifo.pop(regions.getNumFrames());
+    }
+
+    producer.join();
+    REQUIRE(inOrder);
+    REQUIRE(fifo.size() == 0);
+}
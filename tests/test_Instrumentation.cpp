@@ -0,0 +1,93 @@
+#include "tb_Instrumentation.h"
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tb::instrumentation;
+
+namespace {
+const StageStats& statsFor(const Snapshot& snapshot, Stage stage) {
+    return snapshot[static_cast<std::size_t>(stage)];
+}
+}
+
+TEST_CASE("Instrumentation - records calls, total and max per stage", "[Instrumentation]") {
+    reset();
+
+    record(Stage::MelApply, 100);
+    record(Stage::MelApply, 300);
+    record(Stage::FifoPop, 7);
+
+    const auto snapshot = getSnapshot();
+    REQUIRE(statsFor(snapshot, Stage::MelApply).calls == 2);
+    REQUIRE(statsFor(snapshot, Stage::MelApply).totalNanoseconds == 400);
+    REQUIRE(statsFor(snapshot, Stage::MelApply).maxNanoseconds == 300);
+    REQUIRE(statsFor(snapshot, Stage::FifoPop).calls == 1);
+    REQUIRE(statsFor(snapshot, Stage::SrcProcess).calls == 0);
+
+    reset();
+    REQUIRE(statsFor(getSnapshot(), Stage::MelApply).calls == 0);
+}
+
+TEST_CASE("Instrumentation - snapshot merges threads", "[Instrumentation]") {
+    reset();
+
+    constexpr int kNumThreads = 4;
+    constexpr int kCallsPerThread = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < kCallsPerThread; ++i)
+                record(Stage::SpectralFlux, static_cast<uint64_t>(t + 1));
+        });
+    }
+
+    // Snapshots taken mid-flight must never see more than has been recorded
+    while (statsFor(getSnapshot(), Stage::SpectralFlux).calls < kNumThreads * kCallsPerThread)
+        REQUIRE(statsFor(getSnapshot(), Stage::SpectralFlux).maxNanoseconds <= kNumThreads);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto snapshot = getSnapshot();
+    const auto& stats = statsFor(snapshot, Stage::SpectralFlux);
+    REQUIRE(stats.calls == kNumThreads * kCallsPerThread);
+    REQUIRE(stats.totalNanoseconds == kCallsPerThread * (1 + 2 + 3 + 4));
+    REQUIRE(stats.maxNanoseconds == kNumThreads);
+}
+
+TEST_CASE("Instrumentation - exited threads release their slots", "[Instrumentation]") {
+    reset();
+
+    // Far more threads than slots over time, but only one alive at once
+    constexpr int kNumThreads = static_cast<int>(kMaxThreads) * 3;
+    for (int t = 0; t < kNumThreads; ++t)
+        std::thread([] { record(Stage::FifoPush, 5); }).join();
+
+    const auto snapshot = getSnapshot();
+    REQUIRE(statsFor(snapshot, Stage::FifoPush).calls == kNumThreads);
+    REQUIRE(statsFor(snapshot, Stage::FifoPush).totalNanoseconds == kNumThreads * 5);
+    REQUIRE(statsFor(snapshot, Stage::FifoPush).maxNanoseconds == 5);
+
+    // A new thread still gets a slot of its own
+    bool ownSlot = false;
+    std::thread([&] { ownSlot = &detail::currentSlot() != &detail::gSharedSlot; }).join();
+    REQUIRE(ownSlot);
+}
+
+TEST_CASE("Instrumentation - ScopedTimer records its lifetime", "[Instrumentation]") {
+    reset();
+    {
+        const ScopedTimer timer(Stage::SrcProcess);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    const auto snapshot = getSnapshot();
+    const auto& stats = statsFor(snapshot, Stage::SrcProcess);
+    REQUIRE(stats.calls == 1);
+    REQUIRE(stats.totalNanoseconds >= 2'000'000);
+    REQUIRE(stats.maxNanoseconds == stats.totalNanoseconds);
+    REQUIRE(std::string(getStageName(Stage::SrcProcess)) == "src_process");
+}
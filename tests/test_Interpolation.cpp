@@ -0,0 +1,263 @@
+#include "tb_Interpolation.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+
+std::vector<tb::Point> makeControlPoints(int numPoints) {
+    std::vector<tb::Point> points(numPoints);
+    for (int i = 0; i < numPoints; ++i)
+        points[i] = tb::Point(3.f * static_cast<float>(i), std::sin(0.7f * static_cast<float>(i)) * 10.f);
+    return points;
+}
+
+}
+
+TEST_CASE("catmullRom - precomputed basis matches the reference spline", "[catmullRom]") {
+    const auto defaultIsa = tb::simd::getIsa();
+    for (auto isa : { tb::simd::Isa::Portable, tb::simd::Isa::Sse2, tb::simd::Isa::Avx2,
+                      tb::simd::Isa::Avx512 }) {
+        if (! tb::simd::isSupported(isa))
+            continue;
+        REQUIRE(tb::simd::setIsa(isa) == isa);
+
+        // Segment counts below, at and above the lane width, with a remainder; segments that
+        // fill their last lane group exactly (3 steps) and that spill past it (1 and 16)
+        for (const int numPoints : { 4, 11, 12, 37 }) {
+            for (const int steps : { 1, 3, 16 }) {
+                const auto inLine = makeControlPoints(numPoints);
+                const auto size = tb::catmullRom::outLineSize(numPoints, steps);
+
+                std::vector<tb::Point> reference(size);
+                tb::catmullRom::spline(reference, inLine, steps, tb::catmullRom::Type::Uniform);
+
+                const tb::catmullRom::UniformBasis basis(steps);
+                std::vector<tb::Point> points(size);
+                tb::catmullRom::spline(points, inLine, basis);
+
+                std::vector<float> inX, inY, outX(size), outY(size);
+                for (const auto& p : inLine) {
+                    inX.push_back(p.x);
+                    inY.push_back(p.y);
+                }
+                tb::catmullRom::spline(outX, outY, inX, inY, basis);
+
+                for (int i = 0; i < size; ++i) {
+                    REQUIRE_THAT(points[i].x, WithinAbs(reference[i].x, 1e-4));
+                    REQUIRE_THAT(points[i].y, WithinAbs(reference[i].y, 1e-4));
+                    REQUIRE(outX[i] == points[i].x);
+                    REQUIRE(outY[i] == points[i].y);
+                }
+
+                // Control points are passed through exactly
+                for (int i = 1; i + 1 < numPoints; ++i) {
+                    REQUIRE(points[(i - 1) * (steps + 1)].x == inLine[i].x);
+                    REQUIRE(points[(i - 1) * (steps + 1)].y == inLine[i].y);
+                }
+            }
+        }
+    }
+    tb::simd::setIsa(defaultIsa);
+}
+
+TEST_CASE("catmullRom - centripetal and chordal splines", "[catmullRom]") {
+    using tb::catmullRom::Type;
+
+    SECTION("Equal control point spacing gives the uniform spline") {
+        std::vector<tb::Point> zigzag(9);
+        for (int i = 0; i < 9; ++i)
+            zigzag[i] = tb::Point(static_cast<float>(i), i % 2 == 0 ? 1.f : -1.f);
+
+        const auto size = tb::catmullRom::outLineSize(9, 5);
+        std::vector<tb::Point> uniform(size), other(size);
+        tb::catmullRom::spline(uniform, zigzag, 5, Type::Uniform);
+        for (auto type : { Type::Centripetal, Type::Chordal }) {
+            tb::catmullRom::spline(other, zigzag, 5, type);
+            for (int i = 0; i < size; ++i) {
+                REQUIRE_THAT(other[i].x, WithinAbs(uniform[i].x, 1e-5));
+                REQUIRE_THAT(other[i].y, WithinAbs(uniform[i].y, 1e-5));
+            }
+        }
+    }
+
+    SECTION("Uneven spacing: passes through the control points and stays finite") {
+        const std::vector<tb::Point> inLine { { 0.f, 0.f }, { 0.1f, 5.f }, { 0.2f, 5.f }, { 0.2f, 5.f },
+                                              { 8.f, 0.f }, { 9.f, -1.f } };
+        const auto size = tb::catmullRom::outLineSize(6, 7);
+        std::vector<tb::Point> outLine(size), uniform(size);
+        tb::catmullRom::spline(uniform, inLine, 7, Type::Uniform);
+
+        for (auto type : { Type::Centripetal, Type::Chordal }) {
+            tb::catmullRom::spline(outLine, inLine, 7, type);
+            for (int i = 1; i + 1 < 6; ++i) {
+                REQUIRE(outLine[(i - 1) * 8].x == inLine[i].x);
+                REQUIRE(outLine[(i - 1) * 8].y == inLine[i].y);
+            }
+            bool differsFromUniform = false;
+            for (int i = 0; i < size; ++i) {
+                REQUIRE(std::isfinite(outLine[i].x));
+                REQUIRE(std::isfinite(outLine[i].y));
+                differsFromUniform |= std::abs(outLine[i].y - uniform[i].y) > 1e-3f;
+            }
+            REQUIRE(differsFromUniform);
+        }
+    }
+}
+
+TEST_CASE("catmullRom - sample at sorted positions", "[catmullRom]") {
+    using tb::catmullRom::Type;
+
+    const auto inLine = makeControlPoints(23);
+    const int steps = 4;
+    const auto size = tb::catmullRom::outLineSize(23, steps);
+
+    // The positions spline() generates, plus values outside the drawn range (clamped)
+    std::vector<float> positions { -3.f, 0.5f };
+    for (int i = 0; i < size; ++i)
+        positions.push_back(1.f + static_cast<float>(i) / (steps + 1));
+    positions.push_back(40.f);
+
+    for (auto type : { Type::Uniform, Type::Centripetal, Type::Chordal }) {
+        std::vector<tb::Point> reference(size);
+        tb::catmullRom::spline(reference, inLine, steps, type);
+
+        std::vector<tb::Point> sampled(positions.size());
+        tb::catmullRom::sample(sampled, inLine, positions, type);
+
+        REQUIRE(sampled[0].x == inLine[1].x);
+        REQUIRE(sampled[1].y == inLine[1].y);
+        REQUIRE(sampled.back().x == inLine[21].x);
+        for (int i = 0; i < size; ++i) {
+            REQUIRE_THAT(sampled[i + 2].x, WithinAbs(reference[i].x, 1e-4));
+            REQUIRE_THAT(sampled[i + 2].y, WithinAbs(reference[i].y, 1e-4));
+        }
+    }
+}
+
+TEST_CASE("catmullRom - sample at sorted x values", "[catmullRom]") {
+    using tb::catmullRom::Type;
+
+    // Log-spaced in x, like the bins of a spectrum drawn on a log-frequency axis
+    std::vector<tb::Point> inLine(24);
+    for (std::size_t i = 0; i < inLine.size(); ++i) {
+        const auto f = static_cast<float>(i);
+        inLine[i] = tb::Point(20.f * std::pow(1.4f, f), std::sin(0.9f * f) * 10.f);
+    }
+
+    std::vector<float> xValues { 1.f };
+    for (float x = 30.f; x < 27000.f; x *= 1.013f)
+        xValues.push_back(x);
+    xValues.push_back(1e6f);
+
+    for (auto type : { Type::Uniform, Type::Centripetal, Type::Chordal }) {
+        std::vector<tb::Point> sampled(xValues.size());
+        tb::catmullRom::sampleAtX(sampled, inLine, xValues, type);
+
+        REQUIRE(sampled.front().x == inLine[1].x);
+        REQUIRE(sampled.front().y == inLine[1].y);
+        REQUIRE_THAT(sampled.back().x, WithinAbs(inLine[22].x, 1e-2));
+        REQUIRE_THAT(sampled.back().y, WithinAbs(inLine[22].y, 1e-4));
+
+        // Every point lies on the curve: compare with a dense spline interpolated at the same x
+        const int steps = 400;
+        std::vector<tb::Point> dense(tb::catmullRom::outLineSize(24, steps));
+        tb::catmullRom::spline(dense, inLine, steps, type);
+        std::size_t d = 0;
+        for (std::size_t i = 1; i + 1 < xValues.size(); ++i) {
+            REQUIRE_THAT(sampled[i].x, WithinAbs(xValues[i], 1e-3 * xValues[i]));
+            while (d + 2 < dense.size() && dense[d + 1].x < xValues[i])
+                ++d;
+            const auto u = (xValues[i] - dense[d].x) / (dense[d + 1].x - dense[d].x);
+            REQUIRE_THAT(sampled[i].y, WithinAbs(dense[d].y + u * (dense[d + 1].y - dense[d].y), 2e-2));
+        }
+    }
+
+    // Structure-of-arrays overload writes the same points
+    const tb::PointBuffer controlPoints(inLine);
+    tb::PointBuffer curve(xValues.size());
+    std::vector<tb::Point> sampled(xValues.size());
+    tb::catmullRom::sampleAtX(sampled, inLine, xValues, Type::Centripetal);
+    tb::catmullRom::sampleAtX(curve, controlPoints, xValues, Type::Centripetal);
+    for (std::size_t i = 0; i < xValues.size(); ++i) {
+        REQUIRE(curve[i].x == sampled[i].x);
+        REQUIRE(curve[i].y == sampled[i].y);
+    }
+}
+
+TEST_CASE("PointBuffer - conversions, transform and structure-of-arrays overloads", "[catmullRom][PointBuffer]") {
+    using tb::catmullRom::Type;
+
+    const auto inLine = makeControlPoints(30);
+    const tb::PointBuffer controlPoints(inLine);
+    REQUIRE(controlPoints.size() == inLine.size());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(controlPoints.x().data()) % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(controlPoints.y().data()) % 64 == 0);
+    for (std::size_t i = 0; i < inLine.size(); ++i) {
+        REQUIRE(controlPoints[i].x == inLine[i].x);
+        REQUIRE(controlPoints[i].y == inLine[i].y);
+    }
+
+    const auto roundTrip = controlPoints.toPoints();
+    for (std::size_t i = 0; i < inLine.size(); ++i)
+        REQUIRE(roundTrip[i].y == inLine[i].y);
+
+    // Spline and sample write into a reused buffer, matching the Point overloads
+    const tb::catmullRom::UniformBasis basis(5);
+    const auto size = static_cast<std::size_t>(tb::catmullRom::outLineSize(30, 5));
+    std::vector<tb::Point> expected(size);
+    tb::catmullRom::spline(expected, inLine, basis);
+
+    tb::PointBuffer curve;
+    curve.reserve(size);
+    curve.resize(size);
+    const auto* storage = curve.x().data();
+    tb::catmullRom::spline(curve, controlPoints, basis);
+    for (std::size_t i = 0; i < size; ++i) {
+        REQUIRE(curve[i].x == expected[i].x);
+        REQUIRE(curve[i].y == expected[i].y);
+    }
+
+    const std::vector<float> positions { 1.f, 2.25f, 7.5f, 28.f };
+    std::vector<tb::Point> sampled(positions.size());
+    tb::catmullRom::sample(sampled, inLine, positions, Type::Centripetal);
+    curve.resize(positions.size());
+    tb::catmullRom::sample(curve, controlPoints, positions, Type::Centripetal);
+    REQUIRE(curve.x().data() == storage);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        REQUIRE(curve[i].x == sampled[i].x);
+        REQUIRE(curve[i].y == sampled[i].y);
+    }
+
+    tb::transform(curve, 2.f, 10.f, -1.f, 100.f);
+    REQUIRE(curve[1].x == sampled[1].x * 2.f + 10.f);
+    REQUIRE(curve[1].y == sampled[1].y * -1.f + 100.f);
+}
+
+TEST_CASE("PointBuffer - spline of every type matches the vector overload", "[catmullRom][PointBuffer]") {
+    using tb::catmullRom::Type;
+
+    const auto inLine = makeControlPoints(30);
+    const tb::PointBuffer controlPoints(inLine);
+    const int steps = 7;
+    const auto size = static_cast<std::size_t>(tb::catmullRom::outLineSize(30, steps));
+
+    tb::PointBuffer curve(size);
+    const auto* storage = curve.x().data();
+    for (auto type : { Type::Uniform, Type::Centripetal, Type::Chordal }) {
+        std::vector<tb::Point> expected(size);
+        tb::catmullRom::spline(expected, inLine, steps, type);
+
+        tb::catmullRom::spline(curve, controlPoints, steps, type);
+        REQUIRE(curve.x().data() == storage);
+        for (std::size_t i = 0; i < size; ++i) {
+            REQUIRE_THAT(curve[i].x, WithinAbs(expected[i].x, 1e-4));
+            REQUIRE_THAT(curve[i].y, WithinAbs(expected[i].y, 1e-4));
+        }
+    }
+}
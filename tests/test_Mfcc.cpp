@@ -0,0 +1,94 @@
+#include "tb_Mfcc.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+namespace {
+std::vector<float> melFrame(std::size_t numMelBins, int frame) {
+    std::vector<float> mel(numMelBins);
+    for (std::size_t k = 0; k < numMelBins; ++k)
+        mel[k] = std::sin(0.3f * static_cast<float>(k)) + 0.1f * static_cast<float>(frame * frame % 7) - 2.f;
+    return mel;
+}
+
+// Naive orthonormal DCT-II with the same lifter
+std::vector<double> referenceCepstrum(const std::vector<float>& mel, std::size_t numCoefficients, double lifter) {
+    const auto m = static_cast<double>(mel.size());
+    std::vector<double> c(numCoefficients);
+    for (std::size_t n = 0; n < numCoefficients; ++n) {
+        for (std::size_t k = 0; k < mel.size(); ++k)
+            c[n] += mel[k] * std::cos(std::numbers::pi * n * (k + 0.5) / m);
+        c[n] *= std::sqrt((n == 0 ? 1.0 : 2.0) / m) * (1.0 + lifter / 2.0 * std::sin(std::numbers::pi * n / lifter));
+    }
+    return c;
+}
+}
+
+TEST_CASE("Mfcc - coefficients match a naive DCT-II", "[Mfcc]") {
+    const std::size_t numMel = 40, numCoefficients = 13;
+    tb::Mfcc mfcc(numMel, numCoefficients, 22.f, 0);
+    REQUIRE(mfcc.getLatencyInFrames() == 0);
+
+    const auto mel = melFrame(numMel, 3);
+    REQUIRE(mfcc.process(mel));
+    REQUIRE(mfcc.getDelta().empty());
+
+    const auto expected = referenceCepstrum(mel, numCoefficients, 22.0);
+    for (std::size_t n = 0; n < numCoefficients; ++n)
+        REQUIRE_THAT(mfcc.getCoefficients()[n], WithinAbs(expected[n], 1e-4));
+}
+
+TEST_CASE("Mfcc - incremental deltas match an offline regression", "[Mfcc]") {
+    const std::size_t numMel = 24, numCoefficients = 12;
+    const int width = 2;
+    const int numFrames = GENERATE(20, 3, 1);
+    tb::Mfcc mfcc(numMel, numCoefficients, 22.f, width);
+    REQUIRE(mfcc.getLatencyInFrames() == 2 * width);
+
+    // Offline: cepstra, deltas and delta-deltas with the edges padded by repetition
+    std::vector<std::vector<double>> c(numFrames), d(numFrames), dd(numFrames);
+    for (int t = 0; t < numFrames; ++t)
+        c[t] = referenceCepstrum(melFrame(numMel, t), numCoefficients, 22.0);
+
+    auto regression = [&](const std::vector<std::vector<double>>& x, int t) {
+        std::vector<double> out(numCoefficients);
+        for (int n = 1; n <= width; ++n)
+            for (std::size_t i = 0; i < numCoefficients; ++i)
+                out[i] += n * (x[std::min(t + n, numFrames - 1)][i] - x[std::max(t - n, 0)][i]) / 10.0;
+        return out;
+    };
+    for (int t = 0; t < numFrames; ++t)
+        d[t] = regression(c, t);
+    for (int t = 0; t < numFrames; ++t)
+        dd[t] = regression(d, t);
+
+    int outputFrame = 0;
+    auto checkOutputFrame = [&] {
+        REQUIRE(outputFrame < numFrames);
+        for (std::size_t i = 0; i < numCoefficients; ++i) {
+            REQUIRE_THAT(mfcc.getCoefficients()[i], WithinAbs(c[outputFrame][i], 1e-4));
+            REQUIRE_THAT(mfcc.getDelta()[i], WithinAbs(d[outputFrame][i], 1e-4));
+            REQUIRE_THAT(mfcc.getDeltaDelta()[i], WithinAbs(dd[outputFrame][i], 1e-4));
+        }
+        ++outputFrame;
+    };
+
+    for (int t = 0; t < numFrames; ++t) {
+        if (! mfcc.process(melFrame(numMel, t)))
+            continue;
+
+        REQUIRE(t - outputFrame == 2 * width);
+        checkOutputFrame();
+    }
+
+    // The end of the stream is padded like the offline pass, so every frame comes out
+    while (mfcc.flush())
+        checkOutputFrame();
+    REQUIRE(outputFrame == numFrames);
+    REQUIRE_FALSE(mfcc.flush());
+}
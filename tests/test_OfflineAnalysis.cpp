@@ -0,0 +1,74 @@
+#include "tb_OfflineAnalysis.h"
+#include "tb_ThreadPool.h"
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+TEST_CASE("ThreadPool - runs every task exactly once", "[ThreadPool]") {
+    tb::ThreadPool pool(4);
+    REQUIRE(pool.getNumThreads() == 4);
+
+    for (int run = 0; run < 50; ++run) {
+        std::vector<std::atomic<int>> counts(97);
+        pool.parallelFor(static_cast<int>(counts.size()), [&](int i) { counts[i].fetch_add(1); });
+        for (auto& count : counts)
+            REQUIRE(count.load() == 1);
+    }
+}
+
+TEST_CASE("ThreadPool - rethrows task exceptions", "[ThreadPool]") {
+    tb::ThreadPool pool(3);
+    REQUIRE_THROWS_AS(pool.parallelFor(10, [](int i) {
+        if (i == 7)
+            throw std::runtime_error("task failed");
+    }), std::runtime_error);
+
+    // The pool stays usable afterwards
+    std::atomic<int> total { 0 };
+    pool.parallelFor(10, [&](int i) { total += i; });
+    REQUIRE(total == 45);
+}
+
+TEST_CASE("ThreadPool - nested parallelFor runs inline", "[ThreadPool]") {
+    tb::ThreadPool pool(4);
+    std::vector<std::atomic<int>> counts(8 * 16);
+    pool.parallelFor(8, [&](int outer) {
+        pool.parallelFor(16, [&](int inner) { counts[outer * 16 + inner].fetch_add(1); });
+    });
+    for (auto& count : counts)
+        REQUIRE(count.load() == 1);
+}
+
+TEST_CASE("analyseOffline - parallel output is bit-identical to sequential", "[OfflineAnalysis]") {
+    const int numSamples = 48000;
+    choc::buffer::ChannelArrayBuffer<float> signal(2, numSamples);
+    choc::buffer::setAllSamples(signal, [](int channel, int frame) {
+        const auto t = static_cast<float>(frame) / 48000.f;
+        return std::sin(2.f * 3.14159f * (200.f + 300.f * channel) * t * (1.f + t)) *
+               (frame % 4000 < 200 ? 1.f : 0.3f);
+    });
+
+    tb::OfflineAnalysisSettings settings;
+    settings.frameSize = 1024;
+    settings.hopSize = 256;
+    settings.numMelBins = 40;
+
+    settings.framesPerChunk = 1 << 20;
+    const auto sequential = tb::analyseOffline(signal, settings);
+
+    tb::ThreadPool pool(4);
+    settings.framesPerChunk = 7;
+    const auto parallel = tb::analyseOffline(signal, settings, &pool);
+
+    const auto expectedFrames = tb::numOfflineFrames(numSamples, settings.frameSize, settings.hopSize);
+    REQUIRE(sequential.size() == 2);
+    REQUIRE(parallel.size() == 2);
+    for (int ch = 0; ch < 2; ++ch) {
+        REQUIRE(sequential[ch].numFrames == expectedFrames);
+        REQUIRE(parallel[ch].mel == sequential[ch].mel);
+        REQUIRE(parallel[ch].flux == sequential[ch].flux);
+        REQUIRE(parallel[ch].rms == sequential[ch].rms);
+        REQUIRE(parallel[ch].centroid == sequential[ch].centroid);
+    }
+}
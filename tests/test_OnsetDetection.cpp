@@ -0,0 +1,115 @@
+#include "tb_OnsetDetection.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+std::vector<float> magnitudeFrame(std::size_t numBins, int frame) {
+    std::vector<float> magnitude(numBins);
+    for (std::size_t k = 0; k < numBins; ++k)
+        magnitude[k] = 1.f + std::sin(0.05f * static_cast<float>(k) + 0.7f * static_cast<float>(frame));
+    return magnitude;
+}
+}
+
+TEST_CASE("SpectralFluxTracker - matches spectralFlux on consecutive frames", "[SpectralFluxTracker]") {
+    const std::size_t numBins = 513;
+    tb::SpectralFluxTracker tracker(numBins);
+    tb::SpectralFluxTracker compressed(numBins, 10.f);
+
+    auto previous = magnitudeFrame(numBins, 0);
+    REQUIRE(tracker.process(previous) == 0.f);
+    REQUIRE(compressed.process(previous) == 0.f);
+
+    for (int frame = 1; frame < 8; ++frame) {
+        const auto current = magnitudeFrame(numBins, frame);
+        REQUIRE(tracker.process(current) == tb::spectralFlux(previous, current));
+
+        double expected = 0.0;
+        for (std::size_t k = 0; k < numBins; ++k)
+            expected += std::max(std::log1p(10.0 * current[k]) - std::log1p(10.0 * previous[k]), 0.0);
+        REQUIRE_THAT(compressed.process(current), WithinRel(expected, 1e-4));
+
+        previous = current;
+    }
+
+    tracker.reset();
+    REQUIRE(tracker.process(previous) == 0.f);
+}
+
+TEST_CASE("SpectralFluxTracker - frames written in place match process()", "[SpectralFluxTracker]") {
+    const std::size_t numBins = 257;
+    for (const auto gamma : { 0.f, 10.f }) {
+        tb::SpectralFluxTracker copied(numBins, gamma);
+        tb::SpectralFluxTracker inPlace(numBins, gamma);
+        REQUIRE(inPlace.getNextFrame().size() == numBins);
+
+        for (int frame = 0; frame < 6; ++frame) {
+            const auto magnitude = magnitudeFrame(numBins, frame);
+            const auto expected = copied.process(magnitude);
+
+            std::copy(magnitude.begin(), magnitude.end(), inPlace.getNextFrame().begin());
+            REQUIRE(inPlace.processNextFrame() == expected);
+            REQUIRE(std::equal(inPlace.getLastFrame().begin(), inPlace.getLastFrame().end(),
+                               copied.getLastFrame().begin()));
+        }
+    }
+}
+
+TEST_CASE("SpectralFluxTracker - per-band flux over a mel filterbank", "[SpectralFluxTracker]") {
+    const std::size_t numBins = 257;
+    auto filterbank = tb::sparseMelFilterbank(20, numBins, 16000.0);
+    tb::SpectralFluxTracker tracker(filterbank);
+    REQUIRE(tracker.isBanded());
+    REQUIRE(tracker.getBandFlux().size() == 20);
+
+    auto bandEnergies = [&](const std::vector<float>& magnitude) {
+        std::vector<double> energies(filterbank.numMelBins());
+        for (std::size_t m = 0; m < energies.size(); ++m)
+            for (std::size_t j = 0; j < filterbank.bands[m].length; ++j)
+                energies[m] += filterbank.bandWeights(m)[j] * magnitude[filterbank.bands[m].startBin + j];
+        return energies;
+    };
+
+    const auto first = magnitudeFrame(numBins, 0);
+    const auto second = magnitudeFrame(numBins, 1);
+    tracker.process(first);
+    const auto flux = tracker.process(second);
+
+    const auto before = bandEnergies(first);
+    const auto after = bandEnergies(second);
+    double total = 0.0;
+    for (std::size_t m = 0; m < before.size(); ++m) {
+        const auto expected = std::max(after[m] - before[m], 0.0);
+        REQUIRE_THAT(tracker.getBandFlux()[m], WithinAbs(expected, 1e-4));
+        total += expected;
+    }
+    REQUIRE_THAT(flux, WithinRel(total, 1e-4));
+}
+
+TEST_CASE("AdaptivePeakPicker - finds isolated peaks after its latency", "[AdaptivePeakPicker]") {
+    tb::AdaptivePeakPicker picker;
+    const auto latency = picker.getLatencyInFrames();
+
+    std::vector<float> odf(100, 0.01f);
+    odf[20] = 1.f;
+    odf[21] = 0.6f;  // Shoulder of the same onset
+    odf[50] = 0.8f;
+    odf[52] = 0.9f;  // Beyond postMax, so frame 50 is already reported; within minInterval of it
+    odf[80] = 0.03f; // Too small to clear delta
+
+    std::vector<int64_t> onsets;
+    for (std::size_t n = 0; n < odf.size(); ++n) {
+        if (picker.process(odf[n])) {
+            REQUIRE(picker.getLastOnsetFrame() == static_cast<int64_t>(n) - latency);
+            onsets.push_back(picker.getLastOnsetFrame());
+        }
+    }
+
+    REQUIRE(onsets == std::vector<int64_t> { 20, 50 });
+}
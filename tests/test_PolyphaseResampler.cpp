@@ -0,0 +1,182 @@
+#include "tb_PolyphaseResampler.h"
+#include "tb_DspUtilities.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using namespace tb;
+using Catch::Approx;
+
+namespace {
+
+// Resamples a whole signal in one go, flushing the filter tail
+std::vector<float> resampleAll(PolyphaseResampler& resampler, const choc::buffer::ChannelArrayBuffer<float>& input) {
+    const auto ratio = static_cast<double>(resampler.getUpFactor()) / resampler.getDownFactor();
+    const auto capacity = static_cast<uint32_t>((input.getNumFrames() + resampler.getTapsPerPhase()) * ratio) + 16;
+    choc::buffer::ChannelArrayBuffer<float> output(1, capacity);
+    auto [in, out] = resampler.process(input, output, true);
+    REQUIRE(in.getNumFrames() == 0);
+
+    const auto* samples = output.getChannel(0).data.data;
+    return { samples, samples + out.getNumFrames() };
+}
+
+// Amplitude of the component at frequency in signal[start, start + length), measured with a
+// Blackman-Harris window so that leakage from any other component stays far below -144 dB
+double toneAmplitude(const std::vector<float>& signal, double frequency, double sampleRate, int start, int length) {
+    double re = 0.0, im = 0.0, windowSum = 0.0;
+    for (int i = 0; i < length; ++i) {
+        const auto phase = 2.0 * std::numbers::pi * i / (length - 1);
+        const auto w = 0.35875 - 0.48829 * std::cos(phase) + 0.14128 * std::cos(2.0 * phase) -
+                       0.01168 * std::cos(3.0 * phase);
+        const auto arg = 2.0 * std::numbers::pi * frequency * (start + i) / sampleRate;
+        re += w * signal[start + i] * std::cos(arg);
+        im += w * signal[start + i] * std::sin(arg);
+        windowSum += w;
+    }
+    return 2.0 * std::hypot(re, im) / windowSum;
+}
+
+double toDecibels(double amplitude) { return 20.0 * std::log10(amplitude); }
+
+}
+
+TEST_CASE("PolyphaseResampler - Construction", "[PolyphaseResampler]") {
+    SECTION("Reduces the conversion ratio") {
+        PolyphaseResampler resampler(2, 44100.0, 48000.0, PolyphaseResampler::Quality::Fastest);
+        REQUIRE(resampler.getUpFactor() == 160);
+        REQUIRE(resampler.getDownFactor() == 147);
+        REQUIRE(resampler.getNumChannels() == 2);
+    }
+
+    SECTION("Higher quality uses longer filters") {
+        PolyphaseResampler best(1, 48000.0, 44100.0, PolyphaseResampler::Quality::BestQuality);
+        PolyphaseResampler medium(1, 48000.0, 44100.0, PolyphaseResampler::Quality::MediumQuality);
+        PolyphaseResampler fastest(1, 48000.0, 44100.0, PolyphaseResampler::Quality::Fastest);
+        REQUIRE(best.getTapsPerPhase() > medium.getTapsPerPhase());
+        REQUIRE(medium.getTapsPerPhase() > fastest.getTapsPerPhase());
+    }
+
+    SECTION("Invalid arguments") {
+        REQUIRE_THROWS(PolyphaseResampler(0, 44100.0, 48000.0, PolyphaseResampler::Quality::Fastest));
+        REQUIRE_THROWS(PolyphaseResampler(1, 44100.5, 48000.0, PolyphaseResampler::Quality::Fastest));
+        REQUIRE_THROWS(PolyphaseResampler(1, 44101.0, 48000.0, PolyphaseResampler::Quality::Fastest));
+    }
+}
+
+TEST_CASE("PolyphaseResampler - Processing", "[PolyphaseResampler]") {
+    const auto quality = GENERATE(PolyphaseResampler::Quality::BestQuality,
+                                  PolyphaseResampler::Quality::MediumQuality,
+                                  PolyphaseResampler::Quality::Fastest);
+
+    SECTION("Sine keeps its frequency and amplitude") {
+        const double inRate = 44100.0;
+        const double outRate = 48000.0;
+        const float frequency = 1000.f;
+        const int inputFrames = 8820;
+
+        PolyphaseResampler resampler(1, inRate, outRate, quality);
+        auto input = makeSineWave(frequency, inRate, 1, inputFrames);
+        choc::buffer::ChannelArrayBuffer<float> output(1, 12000);
+
+        // Feed in small, uneven blocks
+        auto remainingInput = input.getView();
+        auto remainingOutput = output.getView();
+        int produced = 0;
+        while (remainingInput.getNumFrames() > 0) {
+            const auto blockSize = std::min(257u, remainingInput.getNumFrames());
+            auto [in, out] = resampler.process(remainingInput.getStart(blockSize), remainingOutput);
+            REQUIRE(in.getNumFrames() == 0);
+            produced += static_cast<int>(out.getNumFrames());
+            remainingInput = remainingInput.fromFrame(blockSize);
+            remainingOutput = remainingOutput.fromFrame(out.getNumFrames());
+        }
+
+        auto [in, out] = resampler.process(remainingInput, remainingOutput, true);
+        produced += static_cast<int>(out.getNumFrames());
+
+        const auto latency = resampler.getLatencyInSamples();
+        const auto expectedFrames = (inputFrames + latency + 1) * outRate / inRate;
+        REQUIRE(produced == Approx(expectedFrames).margin(2.0));
+
+        // Compare against the ideal delayed sine, away from the start-up and flush transients
+        const auto delay = (static_cast<double>(resampler.getTapsPerPhase()) * resampler.getUpFactor() - 1.0) /
+                           (2.0 * resampler.getUpFactor() * inRate);
+        for (int i = 2000; i < 8000; ++i) {
+            const auto expected = std::sin(2.0 * std::numbers::pi * frequency * (i / outRate - delay));
+            REQUIRE(output.getSample(0, i) == Approx(expected).margin(1e-3));
+        }
+    }
+
+    SECTION("Downsampling preserves DC") {
+        PolyphaseResampler resampler(2, 48000.0, 44100.0, quality);
+        choc::buffer::ChannelArrayBuffer<float> input(2, 4800);
+        choc::buffer::setAllSamples(input, [](int channel, int) { return channel == 0 ? 0.5f : -0.25f; });
+        choc::buffer::ChannelArrayBuffer<float> output(2, 4410);
+
+        auto [in, out] = resampler.process(input, output);
+        REQUIRE(in.getNumFrames() == 0);
+        REQUIRE(out.getNumFrames() > 3000);
+
+        for (uint32_t i = static_cast<uint32_t>(resampler.getTapsPerPhase()); i < out.getNumFrames(); ++i) {
+            REQUIRE(output.getSample(0, i) == Approx(0.5f).margin(1e-4));
+            REQUIRE(output.getSample(1, i) == Approx(-0.25f).margin(1e-4));
+        }
+    }
+}
+
+TEST_CASE("PolyphaseResampler - Quality tiers meet their passband and stopband", "[PolyphaseResampler]") {
+    struct Tier {
+        PolyphaseResampler::Quality quality;
+        double stopbandDb;
+        double passband;
+    };
+
+    // The documented targets; the measured rejection may fall short by a few dB of float rounding
+    const auto tier = GENERATE(Tier { PolyphaseResampler::Quality::BestQuality, 144.0, 0.96 },
+                               Tier { PolyphaseResampler::Quality::MediumQuality, 121.0, 0.90 },
+                               Tier { PolyphaseResampler::Quality::Fastest, 97.0, 0.80 });
+    const double toleranceDb = 3.0;
+    const double lowNyquist = 22050.0;
+    const int numSamples = 32768;
+
+    SECTION("Passband is flat up to its edge") {
+        for (auto [inRate, outRate] : { std::pair { 44100.0, 48000.0 }, std::pair { 48000.0, 44100.0 } }) {
+            for (auto fraction : { 0.05, 0.3, 0.6, 0.8, tier.passband }) {
+                const auto frequency = fraction * lowNyquist;
+                PolyphaseResampler resampler(1, inRate, outRate, tier.quality);
+                const auto output = resampleAll(resampler, makeSineWave(static_cast<float>(frequency), inRate, 1,
+                                                                        numSamples + 8192));
+                const auto gainDb = toDecibels(toneAmplitude(output, frequency, outRate, 4096, numSamples));
+                REQUIRE(std::abs(gainDb) < 1e-3);
+            }
+        }
+    }
+
+    SECTION("Downsampling rejects aliases") {
+        // 48k → 44.1k: input above 22.05 kHz folds back to 44.1k - f
+        for (auto frequency : { 22100.0, 22800.0, 23900.0 }) {
+            PolyphaseResampler resampler(1, 48000.0, 44100.0, tier.quality);
+            const auto output = resampleAll(resampler, makeSineWave(static_cast<float>(frequency), 48000.0, 1,
+                                                                    numSamples + 8192));
+            const auto aliasDb = toDecibels(toneAmplitude(output, 44100.0 - frequency, 44100.0, 4096, numSamples));
+            REQUIRE(aliasDb < -(tier.stopbandDb - toleranceDb));
+        }
+    }
+
+    SECTION("Upsampling rejects images") {
+        // 44.1k → 48k: a tone at f leaves an image at 44.1k - f (folding back below 24 kHz if above it)
+        for (auto fraction : { 0.5, tier.passband }) {
+            const auto frequency = fraction * lowNyquist;
+            PolyphaseResampler resampler(1, 44100.0, 48000.0, tier.quality);
+            const auto output = resampleAll(resampler, makeSineWave(static_cast<float>(frequency), 44100.0, 1,
+                                                                    numSamples + 8192));
+            const auto imageDb = toDecibels(toneAmplitude(output, 44100.0 - frequency, 48000.0, 4096, numSamples));
+            REQUIRE(imageDb < -(tier.stopbandDb - toleranceDb));
+        }
+    }
+}
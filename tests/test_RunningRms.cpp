@@ -0,0 +1,83 @@
+#include "tb_AudioFeatures.h"
+#include "tb_RunningRms.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <choc_SampleBuffers.h>
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+choc::buffer::ChannelArrayBuffer<float> noise(int numChannels, int numFrames) {
+    choc::buffer::ChannelArrayBuffer<float> buffer(numChannels, numFrames);
+    uint32_t state = 12345;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < numFrames; ++i) {
+            state = state * 1664525u + 1013904223u;
+            buffer.getSample(ch, i) = static_cast<float>(ch + 1) * (static_cast<float>(state >> 8) / 16777216.f - 0.5f);
+        }
+    }
+    return buffer;
+}
+}
+
+TEST_CASE("RunningRms - sliding window matches rmsEnergy over the last window", "[RunningRms]") {
+    const int numChannels = 3;
+    const int windowSize = 100;
+    const auto input = noise(numChannels, 1037);
+
+    tb::RunningRms rms(numChannels, windowSize);
+    choc::buffer::ChannelArrayBuffer<float> output(numChannels, 1037);
+
+    // Uneven block sizes, crossing the ring wrap-around
+    int start = 0;
+    for (int block = 1; start < 1037; block = block * 7 % 151 + 1) {
+        const auto end = std::min(1037, start + block);
+        const choc::buffer::FrameRange range { static_cast<uint32_t>(start), static_cast<uint32_t>(end) };
+        rms.process(input.getFrameRange(range), output.getFrameRange(range));
+        start = end;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i : { 0, 50, 99, 100, 517, 1036 }) {
+            const auto first = std::max(0, i + 1 - windowSize);
+            double sum = 0.0;
+            for (int j = first; j <= i; ++j)
+                sum += static_cast<double>(input.getSample(ch, j)) * input.getSample(ch, j);
+            REQUIRE_THAT(output.getSample(ch, i), WithinRel(std::sqrt(sum / windowSize), 1e-5));
+        }
+
+        const std::span<const float> lastWindow(input.getChannel(ch).data.data + 1037 - windowSize, windowSize);
+        REQUIRE_THAT(rms.getRms(ch), WithinRel(tb::rmsEnergy(lastWindow), 1e-5f));
+    }
+}
+
+TEST_CASE("RunningRms - exponential mode converges to the signal's RMS", "[RunningRms]") {
+    tb::RunningRms rms(1, 64, tb::RunningRms::Mode::Exponential);
+
+    choc::buffer::ChannelArrayBuffer<float> block(1, 256);
+    for (uint32_t i = 0; i < block.getNumFrames(); ++i)
+        block.getSample(0, i) = 0.5f;
+    for (int i = 0; i < 20; ++i)
+        rms.process(block);
+    REQUIRE_THAT(rms.getRms(0), WithinAbs(0.5f, 1e-4f));
+
+    // After one time constant of silence, the mean square has fallen to 1/e
+    choc::buffer::ChannelArrayBuffer<float> silence(1, 64);
+    silence.clear();
+    rms.process(silence);
+    REQUIRE_THAT(rms.getMeanSquare(0), WithinRel(0.25 * std::exp(-1.0), 1e-3));
+
+    rms.reset();
+    REQUIRE(rms.getRms(0) == 0.f);
+}
+
+TEST_CASE("RunningRms - invalid arguments throw tb::Error", "[RunningRms]") {
+    REQUIRE_THROWS_AS(tb::RunningRms(0, 100), tb::Error);
+    REQUIRE_THROWS_AS(tb::RunningRms(-1, 100), tb::Error);
+    REQUIRE_THROWS_AS(tb::RunningRms(1, 0), tb::Error);
+    REQUIRE_THROWS_AS(tb::RunningRms(1, -5, tb::RunningRms::Mode::Exponential), tb::Error);
+}
@@ -0,0 +1,161 @@
+#include "tb_SampleFormat.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("Sample formats - integer round trips and clipping", "[SampleFormat]") {
+    SECTION("int16") {
+        std::vector<int16_t> samples;
+        for (int v = -32768; v <= 32767; v += 7)
+            samples.push_back(static_cast<int16_t>(v));
+        samples.push_back(32767);
+
+        std::vector<float> floats(samples.size());
+        std::vector<int16_t> back(samples.size());
+        tb::convert<int16_t>(samples, floats);
+        tb::convert<int16_t>(floats, back);
+        REQUIRE(back == samples);
+        REQUIRE(floats.front() == -1.f);
+    }
+
+    SECTION("int24") {
+        std::vector<tb::Int24> samples;
+        for (int32_t v = -8388608; v < 8388608; v += 997) {
+            const auto u = static_cast<uint32_t>(v);
+            samples.push_back({ { static_cast<uint8_t>(u), static_cast<uint8_t>(u >> 8), static_cast<uint8_t>(u >> 16) } });
+        }
+
+        std::vector<float> floats(samples.size());
+        std::vector<tb::Int24> back(samples.size());
+        tb::convert<tb::Int24>(samples, floats);
+        tb::convert<tb::Int24>(floats, back);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+            for (int b = 0; b < 3; ++b)
+                REQUIRE(back[i].bytes[b] == samples[i].bytes[b]);
+        REQUIRE(floats.front() == -1.f);
+        REQUIRE_THAT(floats[1], WithinAbs(-1.0 + 997.0 / 8388608.0, 1e-9));
+    }
+
+    SECTION("Out of range floats clip instead of wrapping") {
+        const std::vector<float> loud { 1.f, 1.5f, -1.f, -3.f, 0.49999f / 32768.f };
+        std::vector<int16_t> i16(loud.size());
+        std::vector<int32_t> i32(loud.size());
+        tb::convert<int16_t>(loud, i16);
+        tb::convert<int32_t>(loud, i32);
+
+        REQUIRE(i16 == std::vector<int16_t> { 32767, 32767, -32768, -32768, 0 });
+        REQUIRE(i32[0] == std::numeric_limits<int32_t>::max());
+        REQUIRE(i32[1] == std::numeric_limits<int32_t>::max());
+        REQUIRE(i32[3] == std::numeric_limits<int32_t>::min());
+    }
+}
+
+TEST_CASE("Sample formats - TPDF dither", "[SampleFormat]") {
+    tb::TpdfDither dither(1234);
+    double sum = 0.0, sumOfSquares = 0.0;
+    const int n = 100000;
+    for (int i = 0; i < n; ++i) {
+        const auto d = dither.next();
+        REQUIRE(d > -1.f);
+        REQUIRE(d < 1.f);
+        sum += d;
+        sumOfSquares += static_cast<double>(d) * d;
+    }
+    REQUIRE_THAT(sum / n, WithinAbs(0.0, 0.01));
+    REQUIRE_THAT(sumOfSquares / n, WithinAbs(1.0 / 6.0, 0.01));  // Variance of triangular noise on (-1, 1)
+
+    // A constant half an LSB above zero rounds to 0 or 1 and averages out at 0.5
+    const std::vector<float> constant(n, 0.5f / 32768.f);
+    std::vector<int16_t> quantised(n);
+    tb::convert<int16_t>(constant, quantised, &dither);
+    double mean = 0.0;
+    for (auto q : quantised) {
+        REQUIRE(q >= -1);
+        REQUIRE(q <= 2);
+        mean += q;
+    }
+    REQUIRE_THAT(mean / n, WithinAbs(0.5, 0.02));
+}
+
+TEST_CASE("Sample formats - interleave, deinterleave and direct FIFO pushes", "[SampleFormat]") {
+    const int numChannels = 3;
+    const int numFrames = 700;  // More than one interleave block
+
+    std::vector<int16_t> interleaved(numChannels * numFrames);
+    for (int f = 0; f < numFrames; ++f)
+        for (int ch = 0; ch < numChannels; ++ch)
+            interleaved[f * numChannels + ch] = static_cast<int16_t>((f * 37 + ch * 1000) % 30000 - 15000);
+
+    auto expected = [&](int ch, int f) { return static_cast<float>(interleaved[f * numChannels + ch]) / 32768.f; };
+
+    SECTION("Round trip through planar float") {
+        choc::buffer::ChannelArrayBuffer<float> planar(numChannels, numFrames);
+        tb::deinterleave<int16_t>(interleaved, planar.getView());
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int f = 0; f < numFrames; ++f)
+                REQUIRE(planar.getSample(ch, f) == expected(ch, f));
+
+        std::vector<int16_t> back(interleaved.size());
+        tb::interleave<int16_t>(planar.getView(), back);
+        REQUIRE(back == interleaved);
+    }
+
+    SECTION("Dithered interleave of a view that starts mid-buffer") {
+        choc::buffer::ChannelArrayBuffer<float> planar(numChannels, numFrames);
+        tb::deinterleave<int16_t>(interleaved, planar.getView());
+        const auto view = planar.getView().fromFrame(100);
+
+        std::vector<int16_t> dithered(numChannels * (numFrames - 100));
+        tb::TpdfDither dither(42);
+        tb::interleave<int16_t>(view, dithered, &dither);
+
+        // Dither is drawn frame by frame, channel by channel, in output order
+        tb::TpdfDither reference(42);
+        for (int f = 100; f < numFrames; ++f) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                const std::vector<float> sample { planar.getSample(ch, f) };
+                std::vector<int16_t> quantised(1);
+                tb::convert<int16_t>(sample, quantised, &reference);
+                REQUIRE(dithered[(f - 100) * numChannels + ch] == quantised[0]);
+            }
+        }
+    }
+
+    SECTION("FifoBuffer") {
+        tb::FifoBuffer<float> fifo(numChannels, 1000);
+        REQUIRE(tb::pushInterleaved<int16_t>(fifo, interleaved) == numFrames);
+        REQUIRE(tb::pushInterleaved<int16_t>(fifo, interleaved) == 300);
+        REQUIRE(fifo.isFull());
+
+        fifo.pop(650);
+        const auto buffer = fifo.getBuffer();
+        for (int ch = 0; ch < numChannels; ++ch) {
+            REQUIRE(buffer.getSample(ch, 0) == expected(ch, 650));
+            REQUIRE(buffer.getSample(ch, 349) == expected(ch, 299));
+        }
+    }
+
+    SECTION("SpscFifoBuffer across the wrap point") {
+        tb::SpscFifoBuffer<float> fifo(numChannels, 1000);
+        choc::buffer::ChannelArrayBuffer<float> filler(numChannels, 800);
+        fifo.push(filler);
+        fifo.pop(800);
+
+        REQUIRE(tb::pushInterleaved<int16_t>(fifo, interleaved) == numFrames);
+        const auto regions = fifo.getReadableRegions();
+        REQUIRE(regions.first.getNumFrames() == 200);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            REQUIRE(regions.first.getSample(ch, 0) == expected(ch, 0));
+            REQUIRE(regions.first.getSample(ch, 199) == expected(ch, 199));
+            REQUIRE(regions.second.getSample(ch, 0) == expected(ch, 200));
+            REQUIRE(regions.second.getSample(ch, 499) == expected(ch, 699));
+        }
+    }
+}
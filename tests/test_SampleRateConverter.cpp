@@ -380,3 +380,91 @@ TEST_CASE("SampleRateConverter - getLatencyInSamples", "[SampleRateConverter]")
             SampleRateConverter::Quality::Fastest, 88200.0, 44100.0) >= 0);
     }
 }
+
+TEST_CASE("SampleRateConverter - Parallel processing matches serial", "[SampleRateConverter]") {
+    const int numChannels = 8;
+    const int inputFrames = 4096;
+    const int outputFrames = 4500;
+
+    choc::buffer::ChannelArrayBuffer<float> inputBuffer(numChannels, inputFrames);
+    choc::buffer::setAllSamples(inputBuffer, [](int channel, int frame) {
+        return std::sin(0.01 * (channel + 1) * frame);
+    });
+
+    ThreadPool pool(4);
+    SampleRateConverter serial(numChannels, SampleRateConverter::Quality::MediumQuality);
+    SampleRateConverter parallel(numChannels, SampleRateConverter::Quality::MediumQuality);
+    parallel.setThreadPool(&pool, 0);
+
+    choc::buffer::ChannelArrayBuffer<float> serialOutput(numChannels, outputFrames);
+    choc::buffer::ChannelArrayBuffer<float> parallelOutput(numChannels, outputFrames);
+
+    auto [serialIn, serialOut] = serial.process(inputBuffer, serialOutput, 44100.0, 48000.0, true);
+    auto [parallelIn, parallelOut] = parallel.process(inputBuffer, parallelOutput, 44100.0, 48000.0, true);
+
+    REQUIRE(serialIn.getNumFrames() == parallelIn.getNumFrames());
+    REQUIRE(serialOut.getNumFrames() == parallelOut.getNumFrames());
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (uint32_t i = 0; i < serialOut.getNumFrames(); ++i)
+            REQUIRE(serialOutput.getSample(ch, i) == parallelOutput.getSample(ch, i));
+}
+
+TEST_CASE("SampleRateConverter - Cached latency", "[SampleRateConverter]") {
+    const auto quality = SampleRateConverter::Quality::MediumQuality;
+    const auto first = SampleRateConverter::getLatencyInSamples(quality, 44100.0, 48000.0);
+
+    SECTION("Repeated queries return the same value") {
+        REQUIRE(SampleRateConverter::getLatencyInSamples(quality, 44100.0, 48000.0) == first);
+        REQUIRE(SampleRateConverter::getLatencyInSamples(quality, 88200.0, 96000.0) == first);
+    }
+
+    SECTION("Member query uses the converter's quality") {
+        SampleRateConverter converter(2, quality);
+        REQUIRE(converter.getQuality() == quality);
+        REQUIRE(converter.getLatencyInSamples(44100.0, 48000.0) == first);
+        REQUIRE(converter.getLatencyInSamples(48000.0, 48000.0) == 0);
+    }
+}
+
+TEST_CASE("SampleRateConverter - Interleaved processing", "[SampleRateConverter]") {
+    const int numChannels = 4;
+    const int inputFrames = 1000;
+    const int outputFrames = 1100;
+
+    choc::buffer::ChannelArrayBuffer<float> planarInput(numChannels, inputFrames);
+    choc::buffer::InterleavedBuffer<float> interleavedInput(numChannels, inputFrames);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        for (int i = 0; i < inputFrames; ++i) {
+            const auto sample = static_cast<float>(std::sin(0.02 * (ch + 1) * i));
+            planarInput.getSample(ch, i) = sample;
+            interleavedInput.getSample(ch, i) = sample;
+        }
+    }
+
+    SampleRateConverter planar(numChannels, SampleRateConverter::Quality::Fastest);
+    SampleRateConverter interleaved(numChannels, SampleRateConverter::Quality::Fastest,
+                                    SampleRateConverter::Layout::Interleaved);
+    REQUIRE(interleaved.getNumChannels() == numChannels);
+    REQUIRE(interleaved.getLayout() == SampleRateConverter::Layout::Interleaved);
+
+    choc::buffer::ChannelArrayBuffer<float> planarOutput(numChannels, outputFrames);
+    choc::buffer::InterleavedBuffer<float> interleavedOutput(numChannels, outputFrames);
+
+    auto [planarIn, planarOut] = planar.process(planarInput, planarOutput, 44100.0, 48000.0, true);
+    auto [interleavedIn, interleavedOut] = interleaved.processInterleaved(
+        interleavedInput, interleavedOutput, 44100.0, 48000.0, true);
+
+    REQUIRE(interleavedIn.getNumFrames() == planarIn.getNumFrames());
+    REQUIRE(interleavedOut.getNumFrames() == planarOut.getNumFrames());
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (uint32_t i = 0; i < planarOut.getNumFrames(); ++i)
+            REQUIRE(interleavedOutput.getSample(ch, i) == Approx(planarOutput.getSample(ch, i)).margin(1e-5f));
+
+    REQUIRE_NOTHROW(interleaved.reset());
+
+    // Feeding a converter the other layout would index converter states it does not have
+    REQUIRE_THROWS_AS(interleaved.process(planarInput, planarOutput, 44100.0, 48000.0), tb::Error);
+    REQUIRE_THROWS_AS(planar.processInterleaved(interleavedInput, interleavedOutput, 44100.0, 48000.0), tb::Error);
+    ThreadPool pool(2);
+    REQUIRE_THROWS_AS(interleaved.setThreadPool(&pool), tb::Error);
+}
@@ -0,0 +1,85 @@
+#include "tb_AudioFeatures.h"
+#include "tb_SpectralDescriptors.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("SpectralDescriptors - match a direct multi-pass reference", "[SpectralDescriptors]") {
+    const std::size_t numBins = 1025;
+    const double sampleRate = 44100.0;
+    const double binHz = sampleRate / 2.0 / (numBins - 1);
+
+    std::vector<float> power(numBins);
+    for (std::size_t k = 0; k < numBins; ++k)
+        power[k] = 0.1f + std::exp(-std::pow((static_cast<float>(k) - 200.f) / 60.f, 2.f)) +
+                   0.5f * std::exp(-std::pow((static_cast<float>(k) - 700.f) / 20.f, 2.f));
+
+    double total = 0.0, weighted = 0.0, logSum = 0.0, peak = 0.0;
+    for (std::size_t k = 0; k < numBins; ++k) {
+        total += power[k];
+        weighted += k * binHz * power[k];
+        logSum += std::log(static_cast<double>(power[k]));
+        peak = std::max(peak, static_cast<double>(power[k]));
+    }
+    const auto centroid = weighted / total;
+
+    double c2 = 0.0, c3 = 0.0, c4 = 0.0;
+    for (std::size_t k = 0; k < numBins; ++k) {
+        const auto d = k * binHz - centroid;
+        c2 += d * d * power[k] / total;
+        c3 += d * d * d * power[k] / total;
+        c4 += d * d * d * d * power[k] / total;
+    }
+
+    auto frequencyAt = [&](double fraction) {
+        double cumulative = 0.0;
+        for (std::size_t k = 0; k < numBins; ++k)
+            if ((cumulative += power[k]) >= fraction * total)
+                return k * binHz;
+        return sampleRate / 2.0;
+    };
+
+    tb::SpectralDescriptorAnalyser analyser(numBins, sampleRate);
+    const auto d = analyser.process(power);
+
+    REQUIRE_THAT(d.centroid, WithinRel(centroid, 1e-5));
+    REQUIRE_THAT(d.centroid, WithinRel(tb::spectralCentroid(power, sampleRate), 1e-5f));
+    REQUIRE_THAT(d.spread, WithinRel(std::sqrt(c2), 1e-5));
+    REQUIRE_THAT(d.skewness, WithinRel(c3 / std::pow(c2, 1.5), 1e-4));
+    REQUIRE_THAT(d.kurtosis, WithinRel(c4 / (c2 * c2), 1e-4));
+    REQUIRE_THAT(d.rolloff, WithinAbs(frequencyAt(0.85), 1e-2));
+    REQUIRE_THAT(d.bandwidth, WithinAbs(frequencyAt(0.995) - frequencyAt(0.005), 1e-2));
+    REQUIRE_THAT(d.flatness, WithinRel(std::exp(logSum / numBins) / (total / numBins), 1e-5));
+    REQUIRE_THAT(d.crest, WithinRel(peak / (total / numBins), 1e-5));
+}
+
+TEST_CASE("SpectralDescriptors - flat, single-bin and silent spectra", "[SpectralDescriptors]") {
+    const std::size_t numBins = 257;
+    tb::SpectralDescriptorAnalyser analyser(numBins, 16000.0);
+
+    const std::vector<float> flat(numBins, 2.f);
+    const auto white = analyser.process(flat);
+    REQUIRE_THAT(white.flatness, WithinAbs(1.0, 1e-6));
+    REQUIRE_THAT(white.crest, WithinAbs(1.0, 1e-6));
+    REQUIRE_THAT(white.centroid, WithinRel(4000.0, 1e-6));
+    REQUIRE_THAT(white.skewness, WithinAbs(0.0, 1e-6));
+    REQUIRE_THAT(white.kurtosis, WithinRel(1.8, 1e-3));  // Uniform distribution
+
+    std::vector<float> tone(numBins, 0.f);
+    tone[64] = 1.f;
+    const auto sine = analyser.process(tone);
+    REQUIRE_THAT(sine.centroid, WithinRel(2000.0, 1e-6));
+    REQUIRE_THAT(sine.spread, WithinAbs(0.0, 1e-2));
+    REQUIRE_THAT(sine.rolloff, WithinRel(2000.0, 1e-6));
+    REQUIRE(sine.bandwidth == 0.f);
+    REQUIRE_THAT(sine.crest, WithinRel(static_cast<double>(numBins), 1e-6));
+
+    const std::vector<float> silence(numBins, 0.f);
+    const auto none = analyser.process(silence);
+    REQUIRE(none.centroid == 0.f);
+    REQUIRE(none.flatness == 0.f);
+}
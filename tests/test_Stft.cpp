@@ -0,0 +1,117 @@
+#include "tb_Stft.h"
+#include "tb_DspUtilities.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+
+TEST_CASE("Fft - matches a naive DFT", "[Fft]") {
+    const int size = 64;
+    tb::Fft fft(size);
+
+    std::vector<float> input(size);
+    for (int i = 0; i < size; ++i)
+        input[i] = std::sin(0.3f * i) + 0.25f * std::cos(1.7f * i) + (i % 5 == 0 ? 0.5f : 0.f);
+
+    std::vector<std::complex<float>> output(fft.numBins());
+    fft.forward(input, output);
+
+    for (int k = 0; k < fft.numBins(); ++k) {
+        std::complex<double> expected = 0.0;
+        for (int n = 0; n < size; ++n)
+            expected += static_cast<double>(input[n]) *
+                        std::polar(1.0, -2.0 * std::numbers::pi * k * n / size);
+
+        REQUIRE_THAT(output[k].real(), WithinAbs(expected.real(), 1e-3));
+        REQUIRE_THAT(output[k].imag(), WithinAbs(expected.imag(), 1e-3));
+    }
+}
+
+TEST_CASE("Fft - rejects non power-of-two sizes", "[Fft]") {
+    REQUIRE_THROWS(tb::Fft(100));
+    REQUIRE_THROWS(tb::Fft(2));
+    REQUIRE_NOTHROW(tb::Fft(4));
+}
+
+TEST_CASE("Stft - emits one frame per hop regardless of block size", "[Stft]") {
+    const int frameSize = 256;
+    const int hopSize = 64;
+    const int numSamples = 4096;
+    auto signal = tb::makeSineWave(1000.f, 48000.0, 2, numSamples);
+
+    auto countFrames = [&](int blockSize) {
+        tb::Stft stft(2, frameSize, hopSize);
+        int numFrames = 0;
+        for (int start = 0; start < numSamples; start += blockSize) {
+            const auto end = std::min(start + blockSize, numSamples);
+            numFrames += stft.process(signal.getFrameRange({ static_cast<uint32_t>(start),
+                                                             static_cast<uint32_t>(end) }),
+                                      [](const tb::Stft&) {});
+        }
+        return numFrames;
+    };
+
+    const int expected = (numSamples - frameSize) / hopSize + 1;
+    REQUIRE(countFrames(numSamples) == expected);
+    REQUIRE(countFrames(1) == expected);
+    REQUIRE(countFrames(100) == expected);
+    REQUIRE(countFrames(1000) == expected);
+}
+
+TEST_CASE("Stft - sine peaks at the expected bin", "[Stft]") {
+    const int frameSize = 1024;
+    const double sampleRate = 48000.0;
+    const int expectedBin = 64;
+    const auto frequency = static_cast<float>(expectedBin * sampleRate / frameSize);
+    auto signal = tb::makeSineWave(frequency, sampleRate, 1, frameSize);
+
+    tb::Stft stft(1, frameSize, frameSize / 2, tb::WindowType::BlackmanHarris);
+    int peakBin = -1;
+    stft.process(signal, [&](const tb::Stft& s) {
+        const auto magnitude = s.getMagnitudeSpectrum(0);
+        peakBin = static_cast<int>(std::max_element(magnitude.begin(), magnitude.end()) -
+                                   magnitude.begin());
+
+        const auto power = s.getPowerSpectrum(0);
+        REQUIRE_THAT(power[peakBin], WithinAbs(magnitude[peakBin] * magnitude[peakBin], 1e-2));
+
+        std::vector<float> written(magnitude.size());
+        s.getMagnitudeSpectrum(0, written);
+        REQUIRE(std::equal(written.begin(), written.end(), magnitude.begin()));
+    });
+
+    REQUIRE(peakBin == expectedBin);
+}
+
+TEST_CASE("Stft - power-only mode writes the same magnitudes on request", "[Stft]") {
+    const int frameSize = 512;
+    auto signal = tb::makeSineWave(1000.f, 48000.0, 2, 4096);
+
+    tb::Stft kept(2, frameSize, 128);
+    tb::Stft onRequest(2, frameSize, 128, tb::WindowType::Hann, tb::WindowSymmetry::Symmetric,
+                       tb::Stft::Spectra::PowerOnly);
+    REQUIRE(kept.getSpectra() == tb::Stft::Spectra::PowerAndMagnitude);
+    REQUIRE(onRequest.getSpectra() == tb::Stft::Spectra::PowerOnly);
+
+    std::vector<std::vector<float>> expected;
+    kept.process(signal, [&](const tb::Stft& s) {
+        for (int ch = 0; ch < 2; ++ch) {
+            const auto magnitude = s.getMagnitudeSpectrum(ch);
+            expected.emplace_back(magnitude.begin(), magnitude.end());
+        }
+    });
+
+    std::size_t index = 0;
+    std::vector<float> written(static_cast<std::size_t>(onRequest.getNumBins()));
+    onRequest.process(signal, [&](const tb::Stft& s) {
+        for (int ch = 0; ch < 2; ++ch) {
+            s.getMagnitudeSpectrum(ch, written);
+            REQUIRE(written == expected[index++]);
+        }
+    });
+    REQUIRE(index == expected.size());
+}
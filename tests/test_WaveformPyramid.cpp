@@ -0,0 +1,114 @@
+#include "tb_WaveformPyramid.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <choc_SampleBuffers.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using Catch::Matchers::WithinAbs;
+using Catch::Matchers::WithinRel;
+
+namespace {
+
+choc::buffer::ChannelArrayBuffer<float> makeSignal(int numChannels, int numFrames) {
+    choc::buffer::ChannelArrayBuffer<float> buffer(numChannels, numFrames);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> noise(-0.1f, 0.1f);
+    for (int ch = 0; ch < numChannels; ++ch) {
+        auto* data = buffer.getView().getChannel(ch).data.data;
+        for (int i = 0; i < numFrames; ++i)
+            data[i] = 0.8f * std::sin(0.001f * static_cast<float>(i * (ch + 1))) + noise(rng);
+    }
+    return buffer;
+}
+
+}
+
+TEST_CASE("WaveformPyramid - incremental appends match a single append", "[WaveformPyramid]") {
+    const int numFrames = 50000;
+    auto signal = makeSignal(2, numFrames);
+
+    tb::WaveformPyramid whole(2, 16, 3);
+    whole.append(signal.getView());
+
+    tb::WaveformPyramid live(2, 16, 3);
+    live.reserve(numFrames / 2);
+    std::mt19937 rng(3);
+    for (int start = 0; start < numFrames;) {
+        const auto length = std::min(static_cast<int>(rng() % 700), numFrames - start);
+        live.append(signal.getView().getFrameRange({ static_cast<choc::buffer::FrameCount>(start),
+                                                     static_cast<choc::buffer::FrameCount>(start + length) }));
+        start += length;
+    }
+
+    REQUIRE(live.getNumSamples() == static_cast<std::size_t>(numFrames));
+    REQUIRE(live.getNumLevels() == whole.getNumLevels());
+    REQUIRE(whole.getBucketSize(whole.getNumLevels() - 1) >= static_cast<std::size_t>(numFrames));
+
+    for (const int numPixels : { 7, 300, 4000 }) {
+        std::vector<tb::WaveformSummary> a(numPixels), b(numPixels);
+        whole.query(1, 123.0, numFrames, a);
+        live.query(1, 123.0, numFrames, b);
+        for (int p = 0; p < numPixels; ++p) {
+            REQUIRE(a[p].min == b[p].min);
+            REQUIRE(a[p].max == b[p].max);
+            REQUIRE_THAT(a[p].rms, WithinRel(b[p].rms, 1e-5f));
+        }
+    }
+}
+
+TEST_CASE("WaveformPyramid - query matches a scan of the raw samples", "[WaveformPyramid]") {
+    const int numFrames = 20000;
+    auto signal = makeSignal(1, numFrames);
+    const auto* samples = signal.getView().getChannel(0).data.data;
+
+    tb::WaveformPyramid pyramid(1, 8, 4);
+    pyramid.append(signal.getView());
+
+    // Every pixel covers whole buckets here, so the summaries are exact
+    const int numPixels = 40;
+    const double start = 1024.0;
+    const double end = start + 128.0 * numPixels;  // 128 samples per pixel: level 2, aligned
+    std::vector<tb::WaveformSummary> pixels(numPixels + 10);
+    pyramid.query(0, start, end + 1280.0, pixels);
+
+    for (int p = 0; p < numPixels; ++p) {
+        float lo = samples[1024 + p * 128], hi = lo;
+        double squares = 0.0;
+        for (int i = 1024 + p * 128; i < 1024 + (p + 1) * 128; ++i) {
+            lo = std::min(lo, samples[i]);
+            hi = std::max(hi, samples[i]);
+            squares += static_cast<double>(samples[i]) * samples[i];
+        }
+        REQUIRE(pixels[p].min == lo);
+        REQUIRE(pixels[p].max == hi);
+        REQUIRE_THAT(pixels[p].rms, WithinRel(static_cast<float>(std::sqrt(squares / 128.0)), 1e-5f));
+    }
+
+    // Zoomed out past the end of the recording: empty columns, but no peak is ever lost
+    std::vector<tb::WaveformSummary> overview(100);
+    pyramid.query(0, 0.0, 2.0 * numFrames, overview);
+    REQUIRE(overview[49].max != 0.f);
+    REQUIRE(overview[50].max == 0.f);
+    REQUIRE(overview[99].rms == 0.f);
+    const auto* peak = std::max_element(samples, samples + numFrames);
+    REQUIRE(std::any_of(overview.begin(), overview.end(), [&](const auto& s) { return s.max == *peak; }));
+
+    std::vector<tb::Point> outline(overview.size());
+    tb::toPoints(overview, tb::WaveformValue::Max, 10.f, 2.f, outline);
+    REQUIRE(outline[3].x == 16.f);
+    REQUIRE(outline[3].y == overview[3].max);
+
+    pyramid.clear();
+    REQUIRE(pyramid.getNumSamples() == 0);
+    REQUIRE(pyramid.getNumLevels() == 0);
+}
+
+TEST_CASE("WaveformPyramid - invalid arguments throw tb::Error", "[WaveformPyramid]") {
+    REQUIRE_THROWS_AS(tb::WaveformPyramid(0), tb::Error);
+    REQUIRE_THROWS_AS(tb::WaveformPyramid(-1), tb::Error);
+    REQUIRE_THROWS_AS(tb::WaveformPyramid(1, 0), tb::Error);
+    REQUIRE_THROWS_AS(tb::WaveformPyramid(1, 64, 1), tb::Error);
+}
@@ -0,0 +1,69 @@
+#include "tb_Windowing.h"
+#include <algorithm>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <choc_SampleBuffers.h>
+
+using Catch::Approx;
+
+namespace {
+template<tb::WindowType Type>
+void requireMatchesRuntime() {
+    constexpr auto table = tb::window<double, Type, 257>();
+    const auto reference = tb::window<double>(Type, 257);
+    for (size_t i = 0; i < table.size(); ++i)
+        REQUIRE(table[i] == Approx(reference[i]).margin(1e-14));
+}
+}
+
+TEST_CASE("Windowing - constexpr tables match the runtime windows", "[Windowing]") {
+    static_assert(tb::window<float, tb::WindowType::Hann, 5>()[0] == 0.f);
+    static_assert(tb::window<float, tb::WindowType::Hann, 5>()[2] == 1.f);
+
+    requireMatchesRuntime<tb::WindowType::Hann>();
+    requireMatchesRuntime<tb::WindowType::BlackmanHarris>();
+    requireMatchesRuntime<tb::WindowType::Hamming>();
+}
+
+TEST_CASE("Windowing - cached windows are shared per type, size and precision", "[Windowing]") {
+    const auto a = tb::cachedWindow<float>(tb::WindowType::BlackmanHarris, 1024);
+    const auto b = tb::cachedWindow<float>(tb::WindowType::BlackmanHarris, 1024);
+    REQUIRE(a.data() == b.data());
+    REQUIRE(tb::cachedWindow<float>(tb::WindowType::Hann, 1024).data() != a.data());
+    REQUIRE(tb::cachedWindow<float>(tb::WindowType::BlackmanHarris, 512).size() == 512);
+
+    const auto reference = tb::window<float>(tb::WindowType::BlackmanHarris, 1024);
+    REQUIRE(std::equal(a.begin(), a.end(), reference.begin(), reference.end()));
+}
+
+TEST_CASE("Windowing - periodic windows drop the last sample of a one-longer symmetric window", "[Windowing]") {
+    const auto periodic = tb::window<double>(tb::WindowType::Hann, 64, tb::WindowSymmetry::Periodic);
+    const auto symmetric = tb::window<double>(tb::WindowType::Hann, 65);
+    for (size_t i = 0; i < periodic.size(); ++i)
+        REQUIRE(periodic[i] == Approx(symmetric[i]).margin(1e-15));
+
+    constexpr auto table = tb::window<double, tb::WindowType::Hann, 64, tb::WindowSymmetry::Periodic>();
+    REQUIRE(table[32] == Approx(1.0));
+}
+
+TEST_CASE("Windowing - applyWindow in place and fused into another buffer", "[Windowing]") {
+    const int numFrames = 37;
+    const auto window = tb::cachedWindow<float>(tb::WindowType::BlackmanHarris, numFrames);
+
+    choc::buffer::ChannelArrayBuffer<float> source(3, numFrames);
+    for (uint32_t ch = 0; ch < source.getNumChannels(); ++ch)
+        for (uint32_t i = 0; i < source.getNumFrames(); ++i)
+            source.getSample(ch, i) = static_cast<float>(ch + 1) * (0.5f + static_cast<float>(i));
+
+    choc::buffer::ChannelArrayBuffer<float> fused(3, numFrames);
+    tb::applyWindow(source.getView(), window, fused.getView());
+    tb::applyWindow(source.getView(), window);
+
+    for (uint32_t ch = 0; ch < source.getNumChannels(); ++ch) {
+        for (uint32_t i = 0; i < source.getNumFrames(); ++i) {
+            const auto expected = static_cast<float>(ch + 1) * (0.5f + static_cast<float>(i)) * window[i];
+            REQUIRE(fused.getSample(ch, i) == expected);
+            REQUIRE(source.getSample(ch, i) == expected);
+        }
+    }
+}